@@ -53,6 +53,7 @@ void AudioChild::vReload() {
 	}
 
 	options = std::move(newOptions);
+	valueHandle = { };
 	setUseResultString(!options.infoRequest.empty());
 
 	if (!options.procName.empty()) {
@@ -73,7 +74,7 @@ double AudioChild::vUpdate() {
 	if (legacyNumber < 104) {
 		result = legacy_update();
 	} else {
-		result = parent->getValue(options.procName, options.handlerName, options.channel, options.valueIndex);
+		result = parent->getValue(valueHandle, options.procName, options.handlerName, options.channel, options.valueIndex);
 	}
 
 	result = options.transformer.apply(result);
@@ -168,17 +169,17 @@ AudioChild::Options::Legacy AudioChild::legacy_readOptions() const {
 	return legacy;
 }
 
-double AudioChild::legacy_update() const {
+double AudioChild::legacy_update() {
 	double result = 0.0;
 
 	switch (options.legacy.numberTransform) {
 	case Options::Legacy::NumberTransform::eLINEAR:
-		result = parent->getValue(options.procName, options.handlerName, options.channel, options.valueIndex);
+		result = parent->getValue(valueHandle, options.procName, options.handlerName, options.channel, options.valueIndex);
 		result = result * options.legacy.correctingConstant;
 		break;
 
 	case Options::Legacy::NumberTransform::eDB:
-		result = parent->getValue(options.procName, options.handlerName, options.channel, options.valueIndex);
+		result = parent->getValue(valueHandle, options.procName, options.handlerName, options.channel, options.valueIndex);
 		result = 20.0 / options.legacy.correctingConstant * std::log10(result) + 1.0;
 		break;
 
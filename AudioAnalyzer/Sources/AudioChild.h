@@ -63,6 +63,7 @@ namespace rxtd::audio_analyzer {
 		} options;
 
 		AudioParent* parent = nullptr;
+		AudioParent::ValueHandle valueHandle;
 
 		index legacyNumber;
 
@@ -79,6 +80,6 @@ namespace rxtd::audio_analyzer {
 		Options::Legacy legacy_readOptions() const;
 
 		[[nodiscard]]
-		double legacy_update() const;
+		double legacy_update();
 	};
 }
@@ -10,6 +10,9 @@
 #include "AudioParent.h"
 
 #include "ParamParser.h"
+#include "option-parser/OptionList.h"
+
+using namespace std::string_literals;
 
 using namespace audio_analyzer;
 
@@ -83,6 +86,25 @@ AudioParent::AudioParent(utils::Rainmeter&& _rain) :
 		return;
 	}
 
+	if (const auto performanceLogParams = rain.read(L"PerformanceLog").asMap(L'|', L' ');
+		!performanceLogParams.get(L"file").empty()) {
+		const auto filePath = rain.transformPathToAbsolute(performanceLogParams.get(L"file").asString()) % own();
+		const index rowsCount = std::clamp<index>(performanceLogParams.get(L"rows").asInt(10000), 1, 1000000);
+		helper.setPerformanceLog(filePath, rowsCount);
+
+		const auto untouchedOptions = performanceLogParams.getListOfUntouched();
+		if (!untouchedOptions.empty()) {
+			logger.warning(L"PerformanceLog: unused options: {}", untouchedOptions);
+		}
+	}
+
+	if (const auto imageWriting = rain.read(L"ImageWriting").asIString(L"Direct");
+		imageWriting == L"Background") {
+		imageWriteQueue = std::make_unique<utils::ImageWriteQueue>();
+	} else if (imageWriting != L"Direct") {
+		logger.warning(L"ImageWriting '{}' is not recognized, assume 'Direct'", imageWriting);
+	}
+
 	paramParser.setRainmeter(rain);
 }
 
@@ -101,6 +123,8 @@ void AudioParent::vReload() {
 		updateCleaners();
 	}
 
+	updateValueExports();
+
 	const auto oldCallbacks = std::move(callbacks);
 	callbacks.onUpdate = rain.read(L"callback-onUpdate", false).asString();
 	callbacks.onDeviceChange = rain.read(L"callback-onDeviceChange", false).asString();
@@ -135,12 +159,11 @@ double AudioParent::vUpdate() {
 	}
 
 	{
-		auto& data = helper.getSnapshot().data;
-		auto lock = data.getLock();
+		const auto& data = helper.getSnapshot().readData();
 
 		for (const auto& [procName, procInfo] : paramParser.getParseResult()) {
-			auto iter = data._.find(procName);
-			if (iter == data._.end()) {
+			auto iter = data.find(procName);
+			if (iter == data.end()) {
 				continue;
 			}
 
@@ -157,6 +180,8 @@ double AudioParent::vUpdate() {
 		}
 	}
 
+	writeValueExports();
+
 	return 1.0;
 }
 
@@ -287,7 +312,7 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 		return;
 	}
 
-	if (optionName == L"value" || optionName == L"handlerInfo") {
+	if (optionName == L"value" || optionName == L"values" || optionName == L"handlerInfo") {
 		if (optionName == L"value") {
 			resolveBufferString = L"0";
 
@@ -295,6 +320,13 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 				return;
 			}
 		}
+		if (optionName == L"values") {
+			resolveBufferString = { };
+
+			if (!helper.getSnapshot().deviceIsAvailable) {
+				return;
+			}
+		}
 		if (!requestedSource.has_value()) {
 			// if requestedSource.has_value() then
 			//	even if handlers are not valid due to device connection error
@@ -313,6 +345,8 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 		if (channelName.empty()) {
 			if (optionName == L"value") {
 				logHelpers.generic.log(L"Resolve 'value' requires channel to be specified");
+			} else if (optionName == L"values") {
+				logHelpers.generic.log(L"Resolve 'values' requires channel to be specified");
 			} else {
 				logHelpers.generic.log(L"Resolve 'handlerInfo' requires channel to be specified");
 			}
@@ -322,6 +356,8 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 		if (handlerName.empty()) {
 			if (optionName == L"value") {
 				logHelpers.generic.log(L"Resolve 'value' requires handler to be specified");
+			} else if (optionName == L"values") {
+				logHelpers.generic.log(L"Resolve 'values' requires handler to be specified");
 			} else {
 				logHelpers.generic.log(L"Resolve 'handlerInfo' requires handler to be specified");
 			}
@@ -356,6 +392,14 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 			resolveBufferString = logger.printer.getBufferView();
 			return;
 		}
+		if (optionName == L"values") {
+			if (!isHandlerShouldExist(procName, channelOpt.value(), handlerName)) {
+				return;
+			}
+
+			resolveValues(resolveBufferString, procName, channelOpt.value(), handlerName, map);
+			return;
+		}
 		if (optionName == L"handlerInfo") {
 			auto propName = map.get(L"data").asIString();
 			if (propName.empty()) {
@@ -406,16 +450,93 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 	logHelpers.unknownSectionVariable.log(optionName);
 }
 
+void AudioParent::updateValueExports() {
+	auto oldExports = std::exchange(valueExports, { });
+
+	const auto exportNames = rain.read(L"SharedMemory").asList(L'|');
+	for (const auto& nameOption : exportNames) {
+		const auto name = nameOption.asIString() % own();
+		auto cl = logger.context(L"SharedMemory {}: ", name);
+
+		const auto description = rain.read(L"SharedMemory-"s += name % csView()).asMap(L'|', L' ');
+
+		ValueExport::Params params;
+		params.handlerName = description.get(L"handler").asIString();
+		if (params.handlerName.empty()) {
+			cl.error(L"handler must be specified");
+			continue;
+		}
+
+		params.procName = description.get(L"proc").asIString();
+		if (params.procName.empty()) {
+			params.procName = findProcessingFor(params.handlerName);
+			if (params.procName.empty()) {
+				continue;
+			}
+		}
+
+		const auto channelName = description.get(L"channel").asIString(L"auto");
+		const auto channelOpt = ChannelUtils::parse(channelName);
+		if (!channelOpt.has_value()) {
+			cl.error(L"invalid channel '{}'", channelName);
+			continue;
+		}
+		params.channel = channelOpt.value();
+
+		if (!isHandlerShouldExist(params.procName, params.channel, params.handlerName)) {
+			continue;
+		}
+
+		const auto formatName = description.get(L"format").asIString(L"float");
+		const auto formatOpt = ValueExport::parseFormat(formatName);
+		if (!formatOpt.has_value()) {
+			cl.error(L"unknown format '{}'", formatName);
+			continue;
+		}
+		params.format = formatOpt.value();
+
+		params.mappingName = description.get(L"name").asString();
+		if (params.mappingName.empty()) {
+			cl.error(L"name must be specified");
+			continue;
+		}
+
+		params.capacity = std::clamp<index>(description.get(L"capacity").asInt(1024), 1, 65536);
+
+		auto& data = valueExports[name];
+		if (auto oldIter = oldExports.find(name);
+			oldIter != oldExports.end()) {
+			data = std::move(oldIter->second);
+		}
+
+		if (data.exporter.getParams() == params) {
+			continue;
+		}
+
+		data.handle = { };
+		if (!data.exporter.setParams(std::move(params))) {
+			cl.error(L"can't create shared memory");
+			valueExports.erase(name);
+		}
+	}
+}
+
+void AudioParent::writeValueExports() {
+	for (auto& [name, data] : valueExports) {
+		const auto& params = data.exporter.getParams();
+		data.exporter.write(getValues(data.handle, params.procName, params.handlerName, params.channel));
+	}
+}
+
 double AudioParent::getValue(isview proc, isview id, Channel channel, index ind) {
 	if (!helper.getSnapshot().deviceIsAvailable) {
 		return 0.0;
 	}
 
-	auto& data = helper.getSnapshot().data;
-	auto lock = data.getLock();
+	const auto& data = helper.getSnapshot().readData();
 
-	auto procIter = data._.find(proc);
-	if (procIter == data._.end()) {
+	auto procIter = data.find(proc);
+	if (procIter == data.end()) {
 		return 0.0;
 	}
 
@@ -444,6 +565,148 @@ double AudioParent::getValue(isview proc, isview id, Channel channel, index ind)
 	return values[0][ind];
 }
 
+void AudioParent::resolveValues(
+	string& resolveBufferString,
+	isview procName, Channel channel, isview handlerName,
+	const utils::OptionMap& params
+) {
+	const auto formatName = params.get(L"format").asIString(L"float");
+	const auto formatOpt = ValueExport::parseFormat(formatName);
+	if (!formatOpt.has_value()) {
+		logger.error(L"Resolve 'values': unknown format '{}'", formatName);
+		return;
+	}
+
+	wchar_t delimiter;
+	if (const auto delimiterName = params.get(L"delimiter").asIString(L"comma");
+		delimiterName == L"comma") {
+		delimiter = L',';
+	} else if (delimiterName == L"space") {
+		delimiter = L' ';
+	} else if (delimiterName == L"semicolon") {
+		delimiter = L';';
+	} else {
+		logger.error(L"Resolve 'values': unknown delimiter '{}'", delimiterName);
+		return;
+	}
+
+	ValueHandle handle;
+	const auto values = getValues(handle, procName, handlerName, channel);
+
+	const index begin = std::clamp<index>(params.get(L"from").asInt(0), 0, values.size());
+	const index count = std::clamp<index>(params.get(L"count").asInt(values.size()), 0, values.size() - begin);
+
+	resolveBufferString.clear();
+	for (index i = begin; i < begin + count; i++) {
+		if (i != begin) {
+			resolveBufferString += delimiter;
+		}
+		const double value = ValueExport::quantize(values[i], formatOpt.value());
+		if (formatOpt.value() == ValueExport::Format::eFLOAT) {
+			logger.printer.print(value);
+		} else {
+			logger.printer.print(index(value));
+		}
+		resolveBufferString += logger.printer.getBufferView();
+	}
+}
+
+bool AudioParent::resolvePerformanceProp(
+	string& resolveBufferString,
+	isview procName, Channel channel, isview handlerName, isview valueName
+) {
+	SoundHandler::PerformanceInfo info;
+
+	// handler may not be created yet, in which case all values are zero
+	const auto& data = helper.getSnapshot().readData();
+	if (const auto procIter = data.find(procName);
+		procIter != data.end()) {
+		if (const auto channelIter = procIter->second.find(channel);
+			channelIter != procIter->second.end()) {
+			if (const auto handlerIter = channelIter->second.find(handlerName);
+				handlerIter != channelIter->second.end()) {
+				info = handlerIter->second.performance;
+			}
+		}
+	}
+
+	auto& printer = logger.printer;
+	if (valueName.empty()) {
+		printer.print(
+			L"last {} ms, average {} ms, p99 {} ms, kills {}",
+			info.lastMs, info.averageMs, info.p99Ms, info.killsCount
+		);
+	} else if (valueName == L"last") {
+		printer.print(info.lastMs);
+	} else if (valueName == L"average") {
+		printer.print(info.averageMs);
+	} else if (valueName == L"p99") {
+		printer.print(info.p99Ms);
+	} else if (valueName == L"kills") {
+		printer.print(info.killsCount);
+	} else if (valueName == L"calls") {
+		printer.print(info.callsCount);
+	} else {
+		return false;
+	}
+
+	resolveBufferString = printer.getBufferView();
+	return true;
+}
+
+double AudioParent::getValue(ValueHandle& handle, isview proc, isview id, Channel channel, index ind) {
+	const auto values = getValues(handle, proc, id, channel);
+	if (ind >= values.size()) {
+		return 0.0;
+	}
+
+	return values[ind];
+}
+
+array_view<float> AudioParent::getValues(ValueHandle& handle, isview proc, isview id, Channel channel) {
+	if (!helper.getSnapshot().deviceIsAvailable) {
+		return { };
+	}
+
+	const auto& dataBuffer = helper.getSnapshot().readDataBuffer();
+
+	if (handle.configurationId != dataBuffer.configurationId) {
+		handle.configurationId = dataBuffer.configurationId;
+		handle.handlerIndex = -1;
+
+		const SoundHandler::Snapshot* handlerSnapshot = nullptr;
+		if (auto procIter = dataBuffer._.find(proc);
+			procIter != dataBuffer._.end()) {
+			if (auto channelIter = procIter->second.find(channel);
+				channelIter != procIter->second.end()) {
+				if (auto handlerIter = channelIter->second.find(id);
+					handlerIter != channelIter->second.end()) {
+					handlerSnapshot = &handlerIter->second;
+				}
+			}
+		}
+
+		if (handlerSnapshot != nullptr) {
+			const auto& handlers = dataBuffer.handlers;
+			const auto iter = std::find(handlers.begin(), handlers.end(), handlerSnapshot);
+			if (iter != handlers.end()) {
+				handle.handlerIndex = index(iter - handlers.begin());
+			}
+		}
+	}
+
+	if (handle.handlerIndex < 0) {
+		return { };
+	}
+
+	const auto& values = dataBuffer.handlers[handle.handlerIndex]->values;
+	if (values.getBuffersCount() == 0) {
+		return { };
+	}
+
+	return values[0];
+}
+
 bool AudioParent::isHandlerShouldExist(isview procName, Channel channel, isview handlerName) const {
 	const auto procDataIter = paramParser.getParseResult().find(procName);
 	if (procDataIter == paramParser.getParseResult().end()) {
@@ -552,6 +815,9 @@ AudioParent::DeviceRequest AudioParent::readRequest() const {
 			type.asIString() == L"id") {
 			result.type = ST::eID;
 			result.id = source % csView();
+		} else if (type.asIString() == L"file") {
+			result.type = ST::eFILE;
+			result.id = rain.transformPathToAbsolute(value.asString()) % own();
 		} else {
 			logHelpers.sourceTypeIsNotRecognized.log(type.asIString());
 			return { };
@@ -573,6 +839,20 @@ void AudioParent::resolveProp(
 	const auto handlerInfoIter = procIter0->second.handlersInfo.patchers.find(handlerName);
 
 	const PatchInfo* const handlerInfo = &handlerInfoIter->second;
+
+	if (utils::StringUtils::checkStartsWith(propName, L"perf")) {
+		// timings are available for all handlers, regardless of their type
+		const bool found = resolvePerformanceProp(
+			resolveBufferString,
+			procName, channel, handlerName,
+			utils::StringUtils::trim(propName.substr(4))
+		);
+		if (!found) {
+			logHelpers.propNotFound.log(handlerInfo->type, propName);
+		}
+		return;
+	}
+
 	const auto propGetter = handlerInfo->externalMethods.getProp;
 
 	if (propGetter == nullptr) {
@@ -580,17 +860,16 @@ void AudioParent::resolveProp(
 		return;
 	}
 
-	auto& data = helper.getSnapshot().data;
-	auto lock = data.getLock();
+	const auto& data = helper.getSnapshot().readData();
 
 	// "not found" errors below are not logged because we have already checked everything above,
 	// and if we still don't find requested info then it is caused by either delay in updating second thread
 	// or by device not having requested channel
 
-	SoundHandler::ExternalData* handlerExternalData = nullptr;
+	const SoundHandler::ExternalData* handlerExternalData = nullptr;
 
-	if (auto procIter = data._.find(procName);
-		procIter != data._.end()) {
+	if (auto procIter = data.find(procName);
+		procIter != data.end()) {
 
 		auto& processingSnapshot = procIter->second;
 
@@ -634,6 +913,7 @@ void AudioParent::resolveProp(
 	filePrefix += context.channelName;
 
 	context.filePrefix = filePrefix;
+	context.imageWriteQueue = imageWriteQueue.get();
 
 	const bool found = propGetter(*handlerExternalData, propName, logger.printer, context);
 	if (!found) {
@@ -647,10 +927,8 @@ void AudioParent::resolveProp(
 AudioParent::ProcessingCleanersMap AudioParent::createCleanersFor(const ParamParser::ProcessingData& pd) const {
 	std::set<Channel> channels = pd.channels;
 
-	using HandlerMap = std::map<istring, std::unique_ptr<SoundHandler>, std::less<>>;
-
 	ProcessingManager::ChannelSnapshot tempSnapshot;
-	HandlerMap tempChannelMap;
+	ProcessingManager::ChannelStruct tempChannelStruct;
 
 	for (auto& handlerName : pd.handlersInfo.order) {
 		auto& patchInfo = pd.handlersInfo.patchers.find(handlerName)->second;
@@ -658,7 +936,7 @@ AudioParent::ProcessingCleanersMap AudioParent::createCleanersFor(const ParamPar
 		auto handlerPtr = patchInfo.fun({ });
 
 		auto cl = logger.silent();
-		ProcessingManager::HandlerFinderImpl hf{ tempChannelMap };
+		ProcessingManager::HandlerFinderImpl hf{ tempChannelStruct };
 		SoundHandler::Snapshot handlerSpecificData;
 		const bool success = handlerPtr->patch(
 			patchInfo.params, patchInfo.sources,
@@ -668,7 +946,7 @@ AudioParent::ProcessingCleanersMap AudioParent::createCleanersFor(const ParamPar
 		);
 
 		if (success) {
-			tempChannelMap[handlerName] = std::move(handlerPtr);
+			tempChannelStruct.handlerMap[handlerName] = std::move(handlerPtr);
 			tempSnapshot[handlerName] = std::move(handlerSpecificData);
 		}
 	}
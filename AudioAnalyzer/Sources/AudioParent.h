@@ -12,6 +12,7 @@
 #include "LogErrorHelper.h"
 #include "TypeHolder.h"
 #include "ParentHelper.h"
+#include "ValueExport.h"
 
 namespace rxtd::audio_analyzer {
 	class AudioParent : public utils::ParentBase {
@@ -90,6 +91,9 @@ namespace rxtd::audio_analyzer {
 
 		CleanersMap cleanersMap;
 
+		// nullptr when images are written directly in the main thread
+		std::unique_ptr<utils::ImageWriteQueue> imageWriteQueue;
+
 	public:
 		explicit AudioParent(utils::Rainmeter&& rain);
 
@@ -100,9 +104,27 @@ namespace rxtd::audio_analyzer {
 		void vResolve(array_view<isview> args, string& resolveBufferString) override;
 
 	public:
+		// Position of handler data in the published snapshot.
+		// Found once after each configuration change,
+		// so that reading a value doesn't need any map lookups.
+		struct ValueHandle {
+			index configurationId = -1;
+			// -1 if handler doesn't exist in the current configuration
+			index handlerIndex = -1;
+		};
+
 		[[nodiscard]]
 		double getValue(isview proc, isview id, Channel channel, index ind);
 
+		// same as #getValue above but caches position of the handler in the #handle
+		[[nodiscard]]
+		double getValue(ValueHandle& handle, isview proc, isview id, Channel channel, index ind);
+
+		// Returns first layer of handler values.
+		// Returned view must not be used after any other call to parent.
+		[[nodiscard]]
+		array_view<float> getValues(ValueHandle& handle, isview proc, isview id, Channel channel);
+
 		index getLegacyNumber() const {
 			return paramParser.getLegacyNumber();
 		}
@@ -112,6 +134,13 @@ namespace rxtd::audio_analyzer {
 		isview findProcessingFor(isview handlerName) const;
 
 	private:
+		struct ValueExportData {
+			ValueExport exporter;
+			ValueHandle handle;
+		};
+
+		std::map<istring, ValueExportData, std::less<>> valueExports;
+
 		void runFinisher(
 			SoundHandler::ExternalMethods::FinishMethodType finisher,
 			const SoundHandler::ExternalData& handlerData,
@@ -133,16 +162,29 @@ namespace rxtd::audio_analyzer {
 			filePrefix += context.channelName;
 
 			context.filePrefix = filePrefix;
+			context.imageWriteQueue = imageWriteQueue.get();
 
 			finisher(handlerData, context);
 		}
 
 		void updateCleaners();
+		void updateValueExports();
+		void writeValueExports();
 		DeviceRequest readRequest() const;
 		void resolveProp(
 			string& resolveBufferString,
 			isview procName, Channel channel, isview handlerName, isview propName
 		);
+		void resolveValues(
+			string& resolveBufferString,
+			isview procName, Channel channel, isview handlerName,
+			const utils::OptionMap& params
+		);
+		// returns false if #valueName is not recognized
+		bool resolvePerformanceProp(
+			string& resolveBufferString,
+			isview procName, Channel channel, isview handlerName, isview valueName
+		);
 		ProcessingCleanersMap createCleanersFor(const ParamParser::ProcessingData& pd) const;
 		void runCleaners() const;
 	};
@@ -136,6 +136,18 @@ void ParamParser::parseProcessing(sview name, Logger cl, ProcessingData& oldData
 }
 
 void ParamParser::parseFilters(const utils::OptionMap& optionMap, ProcessingData& data, Logger& cl) const {
+	auto precision = audio_utils::FilterCascade::Precision::DOUBLE;
+	if (const auto precisionString = optionMap.get(L"filterPrecision").asIString(L"double");
+		precisionString == L"float") {
+		precision = audio_utils::FilterCascade::Precision::FLOAT;
+	} else if (precisionString != L"double") {
+		cl.warning(L"filterPrecision '{}' is not recognized, assume 'double'", precisionString);
+	}
+	if (precision != data.filterPrecision) {
+		anythingChanged = true;
+		data.filterPrecision = precision;
+	}
+
 	const auto filterDescription = optionMap.get(L"filter");
 
 	if (filterDescription.asString() == data.rawFccDescription) {
@@ -187,12 +199,33 @@ void ParamParser::parseFilters(const utils::OptionMap& optionMap, ProcessingData
 
 void ParamParser::parseTargetRate(const utils::OptionMap& optionMap, ProcessingData& data, Logger& cl) const {
 	const auto targetRate = optionMap.get(L"targetRate").asInt(defaultTargetRate);
-	if (targetRate == data.targetRate) {
+
+	bool exactResampling = true;
+	auto quality = audio_utils::RationalResampler::Quality::MEDIUM;
+	const auto qualityString = optionMap.get(L"resamplingQuality").asIString(L"integer");
+	if (qualityString == L"integer") {
+		exactResampling = false;
+	} else if (qualityString == L"low") {
+		quality = audio_utils::RationalResampler::Quality::LOW;
+	} else if (qualityString == L"medium") {
+		quality = audio_utils::RationalResampler::Quality::MEDIUM;
+	} else if (qualityString == L"high") {
+		quality = audio_utils::RationalResampler::Quality::HIGH;
+	} else {
+		cl.warning(L"resamplingQuality '{}' is not recognized, assume 'integer'", qualityString);
+		exactResampling = false;
+	}
+
+	if (targetRate == data.targetRate
+		&& exactResampling == data.exactResampling
+		&& quality == data.resamplingQuality) {
 		return;
 	}
 
 	anythingChanged = true;
 	data.targetRate = targetRate;
+	data.exactResampling = exactResampling;
+	data.resamplingQuality = quality;
 }
 
 bool ParamParser::checkListUnique(const utils::OptionList& list) {
@@ -16,6 +16,7 @@
 #include "sound-processing/Channel.h"
 #include "sound-processing/sound-handlers/SoundHandler.h"
 #include "audio-utils/filter-utils/FilterCascadeParser.h"
+#include "audio-utils/RationalResampler.h"
 
 namespace rxtd::audio_analyzer {
 	class ParamParser {
@@ -41,8 +42,12 @@ namespace rxtd::audio_analyzer {
 		struct ProcessingData {
 			string rawFccDescription;
 			audio_utils::FilterCascadeCreator fcc;
+			audio_utils::FilterCascade::Precision filterPrecision{ };
 
 			index targetRate{ };
+			// when false, sample rate is only divided by an integer value, that can result in rate higher than target
+			bool exactResampling{ };
+			audio_utils::RationalResampler::Quality resamplingQuality{ };
 
 			std::set<Channel> channels;
 			HandlerPatchersInfo handlersInfo;
@@ -54,7 +59,10 @@ namespace rxtd::audio_analyzer {
 			friend bool operator==(const ProcessingData& lhs, const ProcessingData& rhs) {
 				return lhs.rawFccDescription == rhs.rawFccDescription
 					&& lhs.fcc == rhs.fcc
+					&& lhs.filterPrecision == rhs.filterPrecision
 					&& lhs.targetRate == rhs.targetRate
+					&& lhs.exactResampling == rhs.exactResampling
+					&& lhs.resamplingQuality == rhs.resamplingQuality
 					&& lhs.channels == rhs.channels
 					&& lhs.handlersInfo == rhs.handlersInfo
 					&& lhs.finishers == rhs.finishers;
@@ -58,10 +58,12 @@ void ParentHelper::init(
 
 	const double warnTime = threadingMap.get(L"warnTime").asFloat(-1.0);
 	const double killTimeout = std::clamp(threadingMap.get(L"killTimeout").asFloat(33.0), 0.01, 33.0);
+	const index workers = std::clamp<index>(threadingMap.get(L"workers").asInt(0), 0, 16);
 
 	mainFields.orchestrator.setLogger(mainFields.logger);
 	mainFields.orchestrator.setWarnTime(warnTime);
 	mainFields.orchestrator.setKillTimeout(killTimeout);
+	mainFields.orchestrator.setWorkersCount(workers);
 
 	double bufferSize = 1.0;
 	if (constFields.useThreading) {
@@ -88,6 +90,10 @@ void ParentHelper::setInvalid() {
 	snapshot.deviceIsAvailable = false;
 }
 
+void ParentHelper::setPerformanceLog(string filePath, index rowsCount) {
+	mainFields.performanceLog.setParams(std::move(filePath), rowsCount);
+}
+
 void ParentHelper::setParams(
 	std::optional<Callbacks> callbacks,
 	std::optional<CaptureManager::SourceDesc> device,
@@ -222,6 +228,7 @@ void ParentHelper::pUpdate() {
 			defaultDeviceChange = changes.defaultOutputChange;
 			break;
 		case ST::eID:
+		case ST::eFILE:
 			defaultDeviceChange = DDC::eNONE;
 			break;
 		}
@@ -302,7 +309,10 @@ void ParentHelper::pUpdate() {
 	}
 	if (needToUpdateHandlers) {
 		updateProcessings();
-		snapshot.data.runGuarded([&] { mainFields.orchestrator.configureSnapshot(snapshot.data._); });
+		mainFields.configurationId++;
+		// other buffers will be reconfigured when processing thread gets them
+		prepareDataBuffer();
+		snapshot.data.publish();
 	}
 	if (needToUpdateDevice) {
 		// callback may want to use some data from snapshot.data,
@@ -322,8 +332,11 @@ void ParentHelper::pUpdate() {
 	}
 
 	if (anyCaptured) {
-		mainFields.orchestrator.process(mainFields.captureManager.getChannelMixer());
-		snapshot.data.runGuarded([&] { mainFields.orchestrator.exchangeData(snapshot.data._); });
+		mainFields.orchestrator.process(mainFields.captureManager.getChannelMixer(), prepareDataBuffer());
+		snapshot.data.publish();
+		if (mainFields.performanceLog.isEnabled()) {
+			mainFields.performanceLog.write(mainFields.orchestrator);
+		}
 		mainFields.rain.executeCommandAsync(mainFields.callbacks.onUpdate);
 	}
 }
@@ -347,6 +360,24 @@ void ParentHelper::updateProcessings() {
 	);
 }
 
+ProcessingOrchestrator::Snapshot& ParentHelper::prepareDataBuffer() {
+	auto& buffer = snapshot.data.getBack();
+	if (buffer.configurationId != mainFields.configurationId) {
+		mainFields.orchestrator.configureSnapshot(buffer._);
+		buffer.configurationId = mainFields.configurationId;
+
+		buffer.handlers.clear();
+		for (const auto& [procName, processingSnapshot] : buffer._) {
+			for (const auto& [channel, channelSnapshot] : processingSnapshot) {
+				for (const auto& [handlerName, handlerSnapshot] : channelSnapshot) {
+					buffer.handlers.push_back(&handlerSnapshot);
+				}
+			}
+		}
+	}
+	return buffer._;
+}
+
 bool ParentHelper::updateDeviceListStrings() {
 	string input;
 	string output;
@@ -11,18 +11,27 @@
 
 #include "DataWithLock.h"
 #include "RainmeterWrappers.h"
+#include "TripleBuffer.h"
 #include "sound-processing/ProcessingManager.h"
 #include "sound-processing/device-management/CaptureManager.h"
 #include "sound-processing/ProcessingOrchestrator.h"
+#include "sound-processing/PerformanceLog.h"
 #include "windows-wrappers/implementations/NotificationClientImpl.h"
 
 namespace rxtd::audio_analyzer {
 	class ParentHelper : MovableOnlyBase {
 	public:
 		struct SnapshotStruct {
-			struct LockableData : DataWithLock {
+			struct DataBuffer {
 				ProcessingOrchestrator::Snapshot _;
-			} data;
+				// configuration that #_ was created for
+				index configurationId = -1;
+				// all handler snapshots of #_ in the order of map traversal,
+				// so index of a handler is the same in all buffers with the same #configurationId
+				std::vector<const SoundHandler::Snapshot*> handlers;
+			};
+			// written by the processing thread, read by the main thread
+			utils::TripleBuffer<DataBuffer> data;
 
 			struct LockableDeviceInfo : DataWithLock {
 				CaptureManager::Snapshot _;
@@ -35,8 +44,21 @@ namespace rxtd::audio_analyzer {
 
 			std::atomic<bool> deviceIsAvailable{ false };
 
+			// Returns last published data.
+			// Must only be called from the main thread.
+			// Returned reference must not be used after next call.
+			[[nodiscard]]
+			const DataBuffer& readDataBuffer() {
+				data.acquire();
+				return data.getFront();
+			}
+
+			[[nodiscard]]
+			const ProcessingOrchestrator::Snapshot& readData() {
+				return readDataBuffer()._;
+			}
+
 			void setThreading(bool value) {
-				data.useLocking = value;
 				deviceInfo.useLocking = value;
 				deviceLists.useLocking = value;
 			}
@@ -85,6 +107,7 @@ namespace rxtd::audio_analyzer {
 			utils::Rainmeter::Logger logger;
 			CaptureManager captureManager;
 			ProcessingOrchestrator orchestrator;
+			PerformanceLog performanceLog;
 
 			struct {
 				CaptureManager::SourceDesc device;
@@ -93,6 +116,7 @@ namespace rxtd::audio_analyzer {
 
 			Callbacks callbacks;
 			bool disconnected = false;
+			index configurationId = 0;
 		} mainFields;
 
 		struct RequestFields : DataWithLock {
@@ -122,6 +146,9 @@ namespace rxtd::audio_analyzer {
 
 		void setInvalid();
 
+		// must be called before first #setParams
+		void setPerformanceLog(string filePath, index rowsCount);
+
 		void setParams(
 			std::optional<Callbacks> callbacks,
 			std::optional<CaptureManager::SourceDesc> device,
@@ -146,6 +173,8 @@ namespace rxtd::audio_analyzer {
 		// returns true device format changed, false otherwise
 		bool reconnectToDevice();
 		void updateProcessings();
+		// returns back data buffer, configured for the current processings
+		ProcessingOrchestrator::Snapshot& prepareDataBuffer();
 		bool updateDeviceListStrings();
 
 		string makeDeviceListString(utils::MediaDeviceType type);
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "ValueExport.h"
+
+using namespace audio_analyzer;
+
+std::optional<ValueExport::Format> ValueExport::parseFormat(isview name) {
+	if (name == L"float") {
+		return Format::eFLOAT;
+	}
+	if (name == L"uint8") {
+		return Format::eUINT8;
+	}
+	if (name == L"uint16") {
+		return Format::eUINT16;
+	}
+	return { };
+}
+
+double ValueExport::quantize(float value, Format format) {
+	switch (format) {
+	case Format::eFLOAT: return value;
+	case Format::eUINT8: return std::floor(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	case Format::eUINT16: return std::floor(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+	}
+	return value;
+}
+
+bool ValueExport::setParams(Params value) {
+	if (value.mappingName != params.mappingName || value.capacity != params.capacity || value.format != params.format) {
+		memory = { };
+		memory = utils::SharedMemory{ value.mappingName, index(sizeof(Header)) + value.capacity * getValueSize(value.format) };
+		if (!memory.isValid()) {
+			params = { };
+			return false;
+		}
+
+		auto& header = getHeader();
+		header.magic = Header::magicValue;
+		header.version = Header::currentVersion;
+		header.headerSize = uint32_t(sizeof(Header));
+		header.format = value.format;
+		header.capacity = uint32_t(value.capacity);
+		header.valuesCount = 0;
+		header.sequence.store(0, std::memory_order_relaxed);
+		header.reserved = 0;
+		header.updatesCount = 0;
+	}
+
+	params = std::move(value);
+	return true;
+}
+
+void ValueExport::write(array_view<float> values) {
+	if (!memory.isValid()) {
+		return;
+	}
+
+	values = { values.data(), std::min(values.size(), params.capacity) };
+
+	auto& header = getHeader();
+	const uint32_t sequence = header.sequence.load(std::memory_order_relaxed);
+	header.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	switch (params.format) {
+	case Format::eFLOAT:
+		writeValues<float>(values);
+		break;
+	case Format::eUINT8:
+		writeValues<uint8_t>(values);
+		break;
+	case Format::eUINT16:
+		writeValues<uint16_t>(values);
+		break;
+	}
+	header.valuesCount = uint32_t(values.size());
+	header.updatesCount++;
+
+	header.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+index ValueExport::getValueSize(Format format) {
+	switch (format) {
+	case Format::eFLOAT: return sizeof(float);
+	case Format::eUINT8: return sizeof(uint8_t);
+	case Format::eUINT16: return sizeof(uint16_t);
+	}
+	return sizeof(float);
+}
+
+template<typename T>
+void ValueExport::writeValues(array_view<float> values) const {
+	auto dest = reinterpret_cast<T*>(memory.getPointer() + sizeof(Header));
+	for (index i = 0; i < values.size(); i++) {
+		dest[i] = T(quantize(values[i], params.format));
+	}
+}
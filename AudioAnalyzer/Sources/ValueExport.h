@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <atomic>
+
+#include "sound-processing/Channel.h"
+#include "windows-wrappers/SharedMemory.h"
+
+namespace rxtd::audio_analyzer {
+	// Copies all values of a handler into a named shared memory block,
+	// so that other programs can read them in one go.
+	//
+	// Block starts with Header, followed by Header#capacity values of Header#format.
+	// Header#sequence is odd while values are being written.
+	// Readers should read the sequence, then values, then the sequence again,
+	// and retry if it was odd or has changed.
+	class ValueExport : MovableOnlyBase {
+	public:
+		enum class Format : uint32_t {
+			eFLOAT = 0,
+			eUINT8 = 1,
+			eUINT16 = 2,
+		};
+
+		struct Header {
+			static constexpr uint32_t magicValue = 0x45564141; // "AAVE" in little endian
+			static constexpr uint32_t currentVersion = 1;
+
+			uint32_t magic;
+			uint32_t version;
+			uint32_t headerSize;
+			Format format;
+			uint32_t capacity;
+			uint32_t valuesCount;
+			std::atomic<uint32_t> sequence;
+			uint32_t reserved;
+			uint64_t updatesCount;
+		};
+
+		static_assert(std::atomic<uint32_t>::is_always_lock_free);
+		static_assert(sizeof(Header) == 40);
+
+		struct Params {
+			istring procName;
+			Channel channel{ };
+			istring handlerName;
+			Format format{ };
+			string mappingName;
+			index capacity{ };
+
+			// autogenerated
+			friend bool operator==(const Params& lhs, const Params& rhs) {
+				return lhs.procName == rhs.procName
+					&& lhs.channel == rhs.channel
+					&& lhs.handlerName == rhs.handlerName
+					&& lhs.format == rhs.format
+					&& lhs.mappingName == rhs.mappingName
+					&& lhs.capacity == rhs.capacity;
+			}
+
+			friend bool operator!=(const Params& lhs, const Params& rhs) {
+				return !(lhs == rhs);
+			}
+		};
+
+	private:
+		Params params;
+		utils::SharedMemory memory;
+
+	public:
+		[[nodiscard]]
+		static std::optional<Format> parseFormat(isview name);
+
+		// float values are returned as is, integer values are scaled from [0, 1] to the whole range of the type
+		[[nodiscard]]
+		static double quantize(float value, Format format);
+
+		// returns false if shared memory can't be created
+		bool setParams(Params value);
+
+		[[nodiscard]]
+		const Params& getParams() const {
+			return params;
+		}
+
+		void write(array_view<float> values);
+
+	private:
+		[[nodiscard]]
+		static index getValueSize(Format format);
+
+		[[nodiscard]]
+		Header& getHeader() const {
+			return *reinterpret_cast<Header*>(memory.getPointer());
+		}
+
+		template<typename T>
+		void writeValues(array_view<float> values) const;
+	};
+}
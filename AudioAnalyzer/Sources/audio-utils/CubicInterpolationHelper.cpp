@@ -22,12 +22,16 @@ double CubicInterpolationHelper::getValueFor(double x) {
 		return sourceValues.back();
 	}
 
-	if (x1 != currentIntervalIndex) {
-		currentIntervalIndex = x1;
-		calcCoefsFor(x1);
+	return getValueAt(x1, x - floor);
+}
+
+double CubicInterpolationHelper::getValueAt(index interval, double offset) {
+	if (interval != currentIntervalIndex) {
+		currentIntervalIndex = interval;
+		calcCoefsFor(interval);
 	}
 
-	const double dx = x - floor;
+	const double dx = offset;
 	double xn = 1.0;
 
 	double result = 0.0;
@@ -31,6 +31,11 @@ namespace rxtd::audio_utils {
 		[[nodiscard]]
 		double getValueFor(double x);
 
+		// same as #getValueFor(interval + offset), but without bounds checking
+		// interval should be < sourceValues.size() - 1, offset should be in [0, 1]
+		[[nodiscard]]
+		double getValueAt(index interval, double offset);
+
 	private:
 		[[nodiscard]]
 		double calcDerivativeFor(index ind) const;
@@ -8,7 +8,7 @@
  */
 
 #pragma once
-#include "GrowingVector.h"
+#include "RingBuffer.h"
 #include "butterworth-lib/ButterworthWrapper.h"
 #include "filter-utils/InfiniteResponseFilter.h"
 
@@ -18,7 +18,7 @@ namespace rxtd::audio_utils {
 		constexpr static index filterSize = ButterworthWrapper::oneSideSlopeSize(filterOrder);
 
 		index decimateFactor = 0;
-		utils::GrowingVector<float> buffer;
+		utils::RingBuffer<float> buffer;
 		InfiniteResponseFilterFixed<filterSize> filter1;
 		InfiniteResponseFilterFixed<filterSize> filter2;
 		InfiniteResponseFilterFixed<filterSize> filter3;
@@ -48,8 +48,6 @@ namespace rxtd::audio_utils {
 		// returns size of the buffer required to grab all of the data downsampled
 		[[nodiscard]]
 		index pushData(array_view<float> source) {
-			buffer.compact();
-
 			auto chunk = buffer.allocateNext(source.size());
 			source.transferToSpan(chunk);
 			filter1.apply(chunk);
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "EnergyHistogram.h"
+
+using namespace audio_utils;
+
+index EnergyHistogram::findBucket(double energy) {
+	const double db = 10.0 * std::log10(energy);
+	const double position = (maxDb - db) * bucketsPerDb;
+	if (!(position > 0.0)) {
+		return 0;
+	}
+	return std::min(index(position), bucketsCount - 1);
+}
+
+void EnergyHistogram::update(index bucket, double sum, index count) {
+	// Fenwick trees are 1-based
+	for (index i = bucket + 1; i <= bucketsCount; i += i & -i) {
+		sums[i] += sum;
+		counts[i] += count;
+	}
+}
+
+EnergyHistogram::Values EnergyHistogram::getPrefix(index size) const {
+	Values result;
+	for (index i = size; i > 0; i -= i & -i) {
+		result.sum += sums[i];
+		result.count += counts[i];
+	}
+	return result;
+}
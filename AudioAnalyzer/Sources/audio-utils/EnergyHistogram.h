@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+
+namespace rxtd::audio_utils {
+	// Multiset of energy values that can tell sum and count of values above a threshold.
+	// Values are grouped into buckets on decibel scale,
+	// and buckets are stored in Fenwick trees, so all operations are O(log(bucketsCount)).
+	// Threshold is only resolved up to bucket size.
+	class EnergyHistogram {
+	public:
+		struct Values {
+			double sum{ };
+			index count{ };
+		};
+
+	private:
+		static constexpr double maxDb = 20.0;
+		static constexpr double minDb = -140.0;
+		static constexpr double bucketsPerDb = 20.0;
+		static constexpr index bucketsCount = index((maxDb - minDb) * bucketsPerDb);
+
+		// bucket 0 holds loudest values, so that values above threshold are a prefix
+		std::vector<double> sums;
+		std::vector<index> counts;
+		// zeros are not in the trees, because they are below any threshold
+		index zeroCount{ };
+
+	public:
+		void reset() {
+			sums.clear();
+			sums.resize(bucketsCount + 1);
+			counts.clear();
+			counts.resize(bucketsCount + 1);
+			zeroCount = 0;
+		}
+
+		void add(double energy) {
+			if (energy <= 0.0) {
+				zeroCount++;
+				return;
+			}
+			update(findBucket(energy), energy, 1);
+		}
+
+		void remove(double energy) {
+			if (energy <= 0.0) {
+				zeroCount--;
+				return;
+			}
+			update(findBucket(energy), -energy, -1);
+		}
+
+		[[nodiscard]]
+		index getZeroCount() const {
+			return zeroCount;
+		}
+
+		// all values, including zeros
+		[[nodiscard]]
+		Values getAll() const {
+			auto result = getPrefix(bucketsCount);
+			result.count += zeroCount;
+			return result;
+		}
+
+		// non-zero values that are >= threshold
+		[[nodiscard]]
+		Values getAbove(double threshold) const {
+			if (threshold <= 0.0) {
+				return getPrefix(bucketsCount);
+			}
+			return getPrefix(findBucket(threshold) + 1);
+		}
+
+	private:
+		[[nodiscard]]
+		static index findBucket(double energy);
+
+		void update(index bucket, double sum, index count);
+
+		// values in buckets [0, size)
+		[[nodiscard]]
+		Values getPrefix(index size) const;
+	};
+}
@@ -8,33 +8,72 @@
  */
 
 #include "FFT.h"
+#include <emmintrin.h>
+
+#include "fft-utils/KissFftBackend.h"
+#include "fft-utils/StockhamFftBackend.h"
 
 using namespace audio_utils;
 
-void FFT::setParams(index newSize, bool correctScalar, std::vector<float> _window) {
+void FFT::setParams(index newSize, bool correctScalar, std::shared_ptr<const std::vector<float>> _window) {
 	fftSize = newSize;
-	scalar = correctScalar ? 1.0f / float(fftSize) : 1.0f / std::sqrtf(float(fftSize));
+	scalar = correctScalar ? 1.0f / float(fftSize) : 1.0f / std::sqrt(float(fftSize));
 	window = std::move(_window);
-	kiss.assign(fftSize / 2, false);
 
-	inputBuffer.resize(fftSize);
-	outputBuffer.resize(fftSize / 2);
+	if (StockhamFftBackend::isSizeSupported(fftSize)) {
+		backend = std::make_unique<StockhamFftBackend>();
+	} else {
+		backend = std::make_unique<KissFftBackend>();
+	}
+	backend->setSize(fftSize);
 }
 
 double FFT::getDC() const {
-	return outputBuffer[0].real() * scalar;
+	return backend->getReal()[0] * scalar;
 }
 
 float FFT::getBinMagnitude(index binIndex) const {
-	const auto v = outputBuffer[binIndex];
-	const float square = v.real() * v.real() + v.imag() * v.imag();
-	return std::sqrt(square) * scalar;
+	const float re = backend->getReal()[binIndex];
+	const float im = backend->getImag()[binIndex];
+	return std::sqrt(re * re + im * im) * scalar;
+}
+
+void FFT::computeMagnitudes(array_span<float> dest) const {
+	computeMagnitudesImpl<false>(dest);
+}
+
+void FFT::computeSquaredMagnitudes(array_span<float> dest) const {
+	computeMagnitudesImpl<true>(dest);
 }
 
 void FFT::process(array_view<float> wave) {
-	for (index i = 0; i < fftSize; ++i) {
-		inputBuffer[i] = wave[i] * window[i];
-	}
+	backend->process(wave, *window);
+}
+
+template<bool squared>
+void FFT::computeMagnitudesImpl(array_span<float> dest) const {
+	const float* real = backend->getReal().data();
+	const float* imag = backend->getImag().data();
+	const index binsCount = std::min<index>(dest.size(), fftSize / 2);
+	const float multiplier = squared ? scalar * scalar : scalar;
 
-	kiss.transform_real(inputBuffer.data(), outputBuffer.data());
+	const __m128 multiplierVector = _mm_set1_ps(multiplier);
+
+	index bin = 0;
+	for (; bin + 4 <= binsCount; bin += 4) {
+		const __m128 re = _mm_loadu_ps(real + bin);
+		const __m128 im = _mm_loadu_ps(imag + bin);
+		__m128 value = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+		if constexpr (!squared) {
+			value = _mm_sqrt_ps(value);
+		}
+		_mm_storeu_ps(dest.data() + bin, _mm_mul_ps(value, multiplierVector));
+	}
+	for (; bin < binsCount; ++bin) {
+		float value = real[bin] * real[bin] + imag[bin] * imag[bin];
+		if constexpr (!squared) {
+			value = std::sqrt(value);
+		}
+		dest[bin] = value * multiplier;
+	}
 }
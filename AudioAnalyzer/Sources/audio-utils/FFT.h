@@ -8,34 +8,56 @@
  */
 
 #pragma once
-#include "kiss_fft-lib/KissFft.hh"
+#include <memory>
 
 namespace rxtd::audio_utils {
-	class FFT {
-		using FftImpl = kiss_fft::KissFft<float>;
+	// Forward transform of real input.
+	// Result is fftSize / 2 complex bins stored as separate real and imaginary arrays.
+	// Bin 0 is packed: real part is DC, imaginary part is nyquist frequency.
+	class FftBackend : VirtualDestructorBase {
+	public:
+		virtual void setSize(index size) = 0;
+
+		// wave and window both have size fftSize
+		virtual void process(array_view<float> wave, array_view<float> window) = 0;
+
+		[[nodiscard]]
+		virtual array_view<float> getReal() const = 0;
+
+		[[nodiscard]]
+		virtual array_view<float> getImag() const = 0;
+	};
 
+	class FFT {
 		index fftSize{ };
 		float scalar{ };
 
-		std::vector<float> window;
+		std::shared_ptr<const std::vector<float>> window;
 
-		FftImpl kiss;
-
-		// need separate input buffer because of window application
-		std::vector<FftImpl::scalar_type> inputBuffer;
-		std::vector<FftImpl::complex_type> outputBuffer;
+		std::unique_ptr<FftBackend> backend;
 
 	public:
 		FFT() = default;
 
-		void setParams(index newSize, bool correctScalar, std::vector<float> window);
+		void setParams(index newSize, bool correctScalar, std::shared_ptr<const std::vector<float>> window);
 
 		[[nodiscard]]
 		double getDC() const;
-		
+
 		[[nodiscard]]
 		float getBinMagnitude(index binIndex) const;
 
+		// dest must have size of fftSize / 2
+		// dest[0] is computed from packed DC and nyquist, same as getBinMagnitude(0)
+		void computeMagnitudes(array_span<float> dest) const;
+
+		// same as computeMagnitudes but without square root
+		void computeSquaredMagnitudes(array_span<float> dest) const;
+
 		void process(array_view<float> wave);
+
+	private:
+		template<bool squared>
+		void computeMagnitudesImpl(array_span<float> dest) const;
 	};
 }
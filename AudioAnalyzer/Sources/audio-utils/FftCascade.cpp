@@ -23,8 +23,11 @@ void FftCascade::setParams(Params _params, FFT* _fftPtr, FftCascade* _successorP
 
 	buffer.reset();
 	buffer.setMaxSize(params.fftSize * 5);
+	downsampleHelper.reset();
+	halfbandDecimator.reset();
 
 	resampleResult();
+	magnitudes.resize(params.fftSize / 2);
 
 	const auto cascadeSampleRate = index(params.samplesPerSec / std::pow(2, _cascadeIndex));
 	filter.setParams(params.legacy_attackTime, params.legacy_decayTime, cascadeSampleRate, params.inputStride);
@@ -38,7 +41,11 @@ void FftCascade::process(array_view<float> wave, clock::time_point killTime) {
 	array_span<float> newChunk;
 
 	const bool needDownsample = cascadeIndex != 0;
-	if (needDownsample) {
+	if (needDownsample && params.decimator == Decimator::HALFBAND) {
+		const auto requiredSize = halfbandDecimator.pushData(wave);
+		newChunk = buffer.allocateNext(requiredSize);
+		halfbandDecimator.decimate(newChunk);
+	} else if (needDownsample) {
 		const auto requiredSize = downsampleHelper.pushData(wave);
 		newChunk = buffer.allocateNext(requiredSize);
 		downsampleHelper.downsampleFixed<2>(newChunk);
@@ -118,8 +125,6 @@ void FftCascade::resampleResult() {
 void FftCascade::doFft(array_view<float> chunk) {
 	fftPtr->process(chunk);
 
-	const auto binsCount = params.fftSize / 2;
-
 	const auto newDC = float(fftPtr->getDC());
 	legacy_dc = filter.apply(legacy_dc, newDC);
 
@@ -128,19 +133,28 @@ void FftCascade::doFft(array_view<float> chunk) {
 		constexpr double root2 = 1.4142135623730950488;
 		legacy_zerothBin *= root2;
 	}
+	if (params.squared) {
+		legacy_zerothBin *= legacy_zerothBin;
+	}
 
 	values[0] = filter.apply(values[0], legacy_zerothBin);
 
+	if (params.squared) {
+		fftPtr->computeSquaredMagnitudes(magnitudes);
+	} else {
+		fftPtr->computeMagnitudes(magnitudes);
+	}
+
+	// bin 0 contains packed DC and nyquist, it is handled separately above
+	auto newValues = array_view<float>{ magnitudes };
+	newValues.remove_prefix(1);
+	auto dest = array_span<float>{ values };
+	dest.remove_prefix(1);
+
 	if (params.legacy_attackTime != 0.0 || params.legacy_decayTime != 0.0) {
-		for (index bin = 1; bin < binsCount; ++bin) {
-			const float oldValue = values[bin];
-			const float newValue = fftPtr->getBinMagnitude(bin);
-			values[bin] = filter.apply(oldValue, newValue);
-		}
+		filter.arrayApply(newValues, dest);
 	} else {
-		for (index bin = 1; bin < binsCount; ++bin) {
-			values[bin] = fftPtr->getBinMagnitude(bin);
-		}
+		newValues.transferToSpan(dest);
 	}
 
 	hasChanges = true;
@@ -14,14 +14,20 @@
 #include "DownsampleHelper.h"
 #include "filter-utils/LogarithmicIRF.h"
 #include "FFT.h"
-#include "GrowingVector.h"
+#include "HalfbandDecimator.h"
+#include "RingBuffer.h"
 
 namespace rxtd::audio_utils {
 	class FftCascade {
 	public:
-		using clock = std::chrono::high_resolution_clock;
+		using clock = std::chrono::steady_clock;
 		static_assert(clock::is_steady);
 
+		enum class Decimator {
+			BUTTERWORTH,
+			HALFBAND,
+		};
+
 		struct Params {
 			index fftSize;
 			index samplesPerSec;
@@ -32,6 +38,12 @@ namespace rxtd::audio_utils {
 			index inputStride;
 			bool legacy_correctZero;
 
+			// produce squared magnitudes instead of magnitudes
+			bool squared;
+
+			// filter used to decimate input of all cascades except the first one
+			Decimator decimator;
+
 			std::function<void(array_view<float> result, index cascade)> callback;
 		};
 
@@ -42,10 +54,12 @@ namespace rxtd::audio_utils {
 		Params params{ };
 		index cascadeIndex{ };
 
-		utils::GrowingVector<float> buffer;
+		utils::RingBuffer<float> buffer;
 		DownsampleHelper downsampleHelper{ 2 };
+		HalfbandDecimator halfbandDecimator;
 		LogarithmicIRF filter{ };
 		std::vector<float> values;
+		std::vector<float> magnitudes;
 		float legacy_dc{ };
 		bool hasChanges = false;
 
@@ -58,6 +72,16 @@ namespace rxtd::audio_utils {
 			return legacy_dc;
 		}
 
+		// delay introduced by decimation of this cascade, in samples of previous cascade
+		// delay of Butterworth filters depends on frequency, so it is not accounted
+		[[nodiscard]]
+		index getLatency() const {
+			if (cascadeIndex == 0 || params.decimator != Decimator::HALFBAND) {
+				return 0;
+			}
+			return HalfbandDecimator::getLatency();
+		}
+
 	private:
 		void resampleResult();
 		void doFft(array_view<float> chunk);
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "HalfbandDecimator.h"
+#include <emmintrin.h>
+
+using namespace audio_utils;
+
+HalfbandDecimator::HalfbandDecimator() {
+	// windowed sinc with cutoff at half of the nyquist frequency
+	// kaiser window with alpha == 2.5 gives about 80 dB of stopband attenuation
+	constexpr double pi = 3.14159265358979323846;
+	constexpr double alpha = 2.5;
+	const double inverseDenominator = 1.0 / std::cyl_bessel_i(0.0, pi * alpha);
+
+	double sum = 0.0;
+	std::array<double, evenTapsCount> coefficients{ };
+	for (index j = 0; j < evenTapsCount; j++) {
+		// distance from the central tap, always odd
+		const index distance = tapsCount / 2 - j * 2;
+		const double x = pi * 0.5 * double(distance);
+		const double sinc = std::sin(x) / x;
+
+		const double windowPosition = double(j * 2) / double(tapsCount - 1) * 2.0 - 1.0;
+		const double window = std::cyl_bessel_i(0.0, pi * alpha * std::sqrt(1.0 - windowPosition * windowPosition)) * inverseDenominator;
+
+		coefficients[j] = 0.5 * sinc * window;
+		sum += coefficients[j];
+	}
+
+	// central coefficient is 0.5, so other coefficients must add up to 0.5 for unity gain at DC
+	const double correction = 0.5 / sum;
+	for (index j = 0; j < evenTapsCount; j++) {
+		evenCoefficients[j] = float(coefficients[j] * correction);
+	}
+
+	reset();
+}
+
+index HalfbandDecimator::pushData(array_view<float> source) {
+	for (const float value : source) {
+		if (nextIsOdd) {
+			oddPhase.push_back(value);
+		} else {
+			evenPhase.push_back(value);
+		}
+		nextIsOdd = !nextIsOdd;
+	}
+
+	return getAvailableSize();
+}
+
+index HalfbandDecimator::decimate(array_span<float> dest) {
+	const index resultSize = std::min(getAvailableSize(), dest.size());
+	if (resultSize <= 0) {
+		return 0;
+	}
+
+	const float* even = evenPhase.data();
+	const float* odd = oddPhase.data() + (sideTapsCount - 1);
+
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	index i = 0;
+	for (; i + 4 <= resultSize; i += 4) {
+		__m128 sum = _mm_mul_ps(_mm_loadu_ps(odd + i), half);
+		for (index j = 0; j < evenTapsCount; j++) {
+			const __m128 coef = _mm_set1_ps(evenCoefficients[j]);
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(even + i + j), coef));
+		}
+		_mm_storeu_ps(dest.data() + i, sum);
+	}
+	for (; i < resultSize; i++) {
+		float sum = odd[i] * 0.5f;
+		for (index j = 0; j < evenTapsCount; j++) {
+			sum += even[i + j] * evenCoefficients[j];
+		}
+		dest[i] = sum;
+	}
+
+	evenPhase.erase(evenPhase.begin(), evenPhase.begin() + resultSize);
+	oddPhase.erase(oddPhase.begin(), oddPhase.begin() + resultSize);
+
+	return resultSize;
+}
+
+void HalfbandDecimator::reset() {
+	// history is filled with silence, so first output sample corresponds to the first input sample
+	evenPhase.clear();
+	evenPhase.resize(getLatency());
+	oddPhase.clear();
+	oddPhase.resize(getLatency());
+	nextIsOdd = false;
+}
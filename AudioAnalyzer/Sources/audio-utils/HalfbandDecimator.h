@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <array>
+
+namespace rxtd::audio_utils {
+	// Decimates by 2 using linear phase half-band FIR filter.
+	//
+	// Every second coefficient of half-band filter is zero, except the central one, which is 0.5,
+	// so filter is evaluated in polyphase form:
+	// even input samples go through short symmetric FIR, odd input samples are only delayed,
+	// and only outputs that survive decimation are computed.
+	//
+	// Unlike Butterworth filters, delay of this filter doesn't depend on frequency,
+	// it is always #getLatency() input samples.
+	class HalfbandDecimator {
+	public:
+		// count of non-zero coefficients on one side of the central coefficient
+		constexpr static index sideTapsCount = 16;
+		constexpr static index evenTapsCount = sideTapsCount * 2;
+		constexpr static index tapsCount = sideTapsCount * 4 - 1;
+
+	private:
+		std::array<float, evenTapsCount> evenCoefficients{ };
+
+		std::vector<float> evenPhase;
+		std::vector<float> oddPhase;
+		bool nextIsOdd = false;
+
+	public:
+		HalfbandDecimator();
+
+		// delay of the filter, in input samples
+		[[nodiscard]]
+		static constexpr index getLatency() {
+			return (tapsCount - 1) / 2;
+		}
+
+		// returns count of output samples that can be grabbed with #decimate
+		[[nodiscard]]
+		index pushData(array_view<float> source);
+
+		// returns count of decimated elements
+		index decimate(array_span<float> dest);
+
+		void reset();
+
+	private:
+		[[nodiscard]]
+		index getAvailableSize() const {
+			return std::min(index(evenPhase.size()) - evenTapsCount + 1, index(oddPhase.size()) - sideTapsCount + 1);
+		}
+	};
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "RationalResampler.h"
+#include <emmintrin.h>
+#include <numeric>
+#include <tuple>
+
+using namespace audio_utils;
+
+namespace {
+	struct QualityPreset {
+		// filter half-size, measured in samples of the lower of two sampling rates
+		index zeroCrossings;
+		// alpha of the kaiser window
+		double alpha;
+		// cutoff frequency relative to the lower of two nyquist frequencies
+		double rolloff;
+	};
+
+	QualityPreset getPreset(RationalResampler::Quality quality) {
+		switch (quality) {
+		case RationalResampler::Quality::LOW: return { 8, 2.0, 0.8 };
+		case RationalResampler::Quality::MEDIUM: return { 16, 2.5, 0.88 };
+		case RationalResampler::Quality::HIGH: return { 32, 3.0, 0.94 };
+		}
+		return { 16, 2.5, 0.88 };
+	}
+}
+
+void RationalResampler::setParams(index inputRate, index targetRate, Quality quality) {
+	const index gcd = std::gcd(inputRate, targetRate);
+	std::tie(upFactor, downFactor) = approximateRatio(targetRate / gcd, inputRate / gcd, maxPhasesCount);
+	outputRate = double(inputRate) * double(upFactor) / double(downFactor);
+
+	const auto preset = getPreset(quality);
+	const index maxFactor = std::max(upFactor, downFactor);
+
+	// each output sample needs zeroCrossings samples of the lower rate on each side,
+	// which is zeroCrossings * downFactor / upFactor input samples when downsampling
+	const double minTapsPerPhase = 2.0 * double(preset.zeroCrossings) * double(maxFactor) / double(upFactor);
+	tapsPerPhase = index(std::ceil(minTapsPerPhase));
+	tapsPerPhase = (tapsPerPhase + 3) / 4 * 4;
+
+	const index filterSize = tapsPerPhase * upFactor;
+
+	constexpr double pi = 3.14159265358979323846;
+	const double cutoff = preset.rolloff * 0.5 / double(maxFactor);
+	const double center = double(filterSize - 1) * 0.5;
+	const double inverseDenominator = 1.0 / std::cyl_bessel_i(0.0, pi * preset.alpha);
+
+	coefficients.resize(filterSize);
+	for (index i = 0; i < filterSize; i++) {
+		const double x = double(i) - center;
+		const double sinc = x == 0.0 ? 1.0 : std::sin(2.0 * pi * cutoff * x) / (2.0 * pi * cutoff * x);
+
+		const double windowPosition = x / center;
+		const double window = std::cyl_bessel_i(0.0, pi * preset.alpha * std::sqrt(std::max(1.0 - windowPosition * windowPosition, 0.0))) * inverseDenominator;
+
+		// upsampling inserts zeros, so gain must be multiplied by upFactor
+		const double value = double(upFactor) * 2.0 * cutoff * sinc * window;
+
+		const index phaseIndex = i % upFactor;
+		const index tapIndex = i / upFactor;
+		coefficients[phaseIndex * tapsPerPhase + (tapsPerPhase - 1 - tapIndex)] = float(value);
+	}
+
+	reset();
+}
+
+index RationalResampler::pushData(array_view<float> source) {
+	history.insert(history.end(), source.begin(), source.end());
+	return getAvailableSize();
+}
+
+index RationalResampler::resample(array_span<float> dest) {
+	const index resultSize = std::min(getAvailableSize(), dest.size());
+
+	for (index i = 0; i < resultSize; i++) {
+		const float* input = history.data() + position - (tapsPerPhase - 1);
+		const float* phaseCoefficients = coefficients.data() + phase * tapsPerPhase;
+
+		__m128 sum = _mm_setzero_ps();
+		for (index j = 0; j < tapsPerPhase; j += 4) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(input + j), _mm_loadu_ps(phaseCoefficients + j)));
+		}
+		sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		dest[i] = _mm_cvtss_f32(sum);
+
+		phase += downFactor;
+		position += phase / upFactor;
+		phase %= upFactor;
+	}
+
+	// only keep samples that are needed for next outputs
+	const index removeCount = std::min(position - (tapsPerPhase - 1), index(history.size()));
+	if (removeCount > 0) {
+		history.erase(history.begin(), history.begin() + removeCount);
+		position -= removeCount;
+	}
+
+	return resultSize;
+}
+
+void RationalResampler::reset() {
+	// History is filled with silence, so that first output sample can be computed from the first input sample.
+	// Output sample n is computed at the time of input sample n * M / L,
+	// but it represents the signal from #getLatency() input samples earlier.
+	history.clear();
+	history.resize(tapsPerPhase - 1);
+	position = tapsPerPhase - 1;
+	phase = 0;
+}
+
+index RationalResampler::getAvailableSize() const {
+	// output sample with index i uses input sample with index (position * L + phase + i * M) / L
+	const index remaining = index(history.size()) * upFactor - (position * upFactor + phase);
+	if (remaining <= 0) {
+		return 0;
+	}
+	return (remaining + downFactor - 1) / downFactor;
+}
+
+std::pair<index, index> RationalResampler::approximateRatio(index numerator, index denominator, index maxNumerator) {
+	if (numerator <= maxNumerator) {
+		return { numerator, denominator };
+	}
+
+	// last convergent of continued fraction that fits into the limit
+	index p0 = 0, q0 = 1;
+	index p1 = 1, q1 = 0;
+	index n = numerator;
+	index d = denominator;
+	while (d != 0) {
+		const index a = n / d;
+		const index p2 = a * p1 + p0;
+		const index q2 = a * q1 + q0;
+		if (p2 > maxNumerator) {
+			break;
+		}
+		p0 = p1;
+		q0 = q1;
+		p1 = p2;
+		q1 = q2;
+
+		n = std::exchange(d, n % d);
+	}
+
+	if (p1 == 0 || q1 == 0) {
+		return { 1, std::max<index>(denominator / std::max<index>(numerator, 1), 1) };
+	}
+	return { p1, q1 };
+}
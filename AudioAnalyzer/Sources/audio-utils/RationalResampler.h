@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+
+namespace rxtd::audio_utils {
+	// Changes sampling rate by a factor of L/M.
+	//
+	// Signal is conceptually upsampled by L, filtered with windowed sinc lowpass and then downsampled by M.
+	// Filter is split into L phases, and only outputs that survive downsampling are computed,
+	// each output sample uses only one phase of the filter.
+	//
+	// Keeps last samples of input between #pushData calls,
+	// so that stream can be fed in chunks of any size.
+	//
+	// Filter is symmetric, so its delay doesn't depend on frequency,
+	// it is always #getLatency() input samples.
+	class RationalResampler {
+	public:
+		enum class Quality {
+			LOW,
+			MEDIUM,
+			HIGH,
+		};
+
+		// filter size is proportional to count of phases
+		// ratios that need more phases are approximated
+		constexpr static index maxPhasesCount = 1024;
+
+	private:
+		index upFactor = 1;
+		index downFactor = 1;
+		index tapsPerPhase = 0;
+		double outputRate = 0.0;
+
+		// coefficients of each phase are stored in reverse order,
+		// so that they can be multiplied by input samples in their natural order
+		std::vector<float> coefficients;
+
+		std::vector<float> history;
+		// index of the last input sample used for next output sample
+		index position = 0;
+		index phase = 0;
+
+	public:
+		void setParams(index inputRate, index targetRate, Quality quality);
+
+		// actual output rate, can differ from target rate
+		// if ratio of rates can't be represented with #maxPhasesCount phases
+		[[nodiscard]]
+		double getOutputRate() const {
+			return outputRate;
+		}
+
+		// delay of the filter, in input samples
+		// about tapsPerPhase / 2, can be fractional
+		[[nodiscard]]
+		double getLatency() const {
+			return double(tapsPerPhase * upFactor - 1) * 0.5 / double(upFactor);
+		}
+
+		// returns count of output samples that can be grabbed with #resample
+		[[nodiscard]]
+		index pushData(array_view<float> source);
+
+		// returns count of resampled elements
+		index resample(array_span<float> dest);
+
+		void reset();
+
+	private:
+		[[nodiscard]]
+		index getAvailableSize() const;
+
+		// finds ratio p/q closest to value with p not exceeding maxNumerator
+		static std::pair<index, index> approximateRatio(index numerator, index denominator, index maxNumerator);
+	};
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "RecursiveGaussian.h"
+#include <complex>
+
+using namespace audio_utils;
+
+void RecursiveGaussian::apply(array_view<float> source, array_span<float> dest, index radius) {
+	const auto& c = getCoefficients(radius);
+
+	const index size = source.size();
+	causalResult.resize(size);
+
+	const auto get = [&](index i) {
+		return i >= 0 && i < size ? double(source[i]) : 0.0;
+	};
+
+	// filter state is kept in variables, so that loop doesn't need to check bounds of results
+	double y1 = 0.0;
+	double y2 = 0.0;
+	double y3 = 0.0;
+	double y4 = 0.0;
+	for (index i = 0; i < size; i++) {
+		const double y0 =
+			c.causal[0] * get(i) + c.causal[1] * get(i - 1) + c.causal[2] * get(i - 2) + c.causal[3] * get(i - 3)
+			- c.feedback[0] * y1 - c.feedback[1] * y2 - c.feedback[2] * y3 - c.feedback[3] * y4;
+		causalResult[i] = y0;
+
+		y4 = y3;
+		y3 = y2;
+		y2 = y1;
+		y1 = y0;
+	}
+
+	y1 = 0.0;
+	y2 = 0.0;
+	y3 = 0.0;
+	y4 = 0.0;
+	for (index i = size - 1; i >= 0; i--) {
+		const double y0 =
+			c.antiCausal[0] * get(i + 1) + c.antiCausal[1] * get(i + 2) + c.antiCausal[2] * get(i + 3) + c.antiCausal[3] * get(i + 4)
+			- c.feedback[0] * y1 - c.feedback[1] * y2 - c.feedback[2] * y3 - c.feedback[3] * y4;
+		dest[i] = float((causalResult[i] + y0) * c.normalization);
+
+		y4 = y3;
+		y3 = y2;
+		y2 = y1;
+		y1 = y0;
+	}
+}
+
+const RecursiveGaussian::Coefficients& RecursiveGaussian::getCoefficients(index radius) {
+	auto iter = coefficients.find(radius);
+	if (iter == coefficients.end()) {
+		iter = coefficients.insert({ radius, calculateCoefficients(double(radius) * (1.0 / 3.0)) }).first;
+	}
+	return iter->second;
+}
+
+RecursiveGaussian::Coefficients RecursiveGaussian::calculateCoefficients(double sigma) {
+	using complex = std::complex<double>;
+
+	// Deriche approximates gaussian as
+	// h(n) = sum_k (a_k * cos(w_k * n / sigma) + b_k * sin(w_k * n / sigma)) * exp(-l_k * n / sigma)
+	// for n >= 0, and each term is a pair of complex conjugate exponents
+	const double a[] = { 1.68, -0.6803 };
+	const double b[] = { 3.735, -0.2598 };
+	const double w[] = { 0.6318, 1.997 };
+	const double l[] = { 1.783, 1.723 };
+
+	// h(n) = sum_k weights[k] * poles[k]^n
+	complex weights[4];
+	complex poles[4];
+	for (index k = 0; k < 2; k++) {
+		weights[k * 2] = complex{ a[k], -b[k] } * 0.5;
+		weights[k * 2 + 1] = std::conj(weights[k * 2]);
+		poles[k * 2] = std::exp(complex{ -l[k], w[k] } / sigma);
+		poles[k * 2 + 1] = std::conj(poles[k * 2]);
+	}
+
+	// Causal part is sum_k weights[k] / (1 - poles[k] * z^-1),
+	// which is expanded into numerator / denominator with common denominator prod_k (1 - poles[k] * z^-1).
+	// Conjugate pairs make all coefficients real.
+	complex denominator[5] = { 1.0 };
+	complex numerator[4] = { };
+	for (index k = 0; k < 4; k++) {
+		for (index i = 4; i >= 1; i--) {
+			denominator[i] -= poles[k] * denominator[i - 1];
+		}
+
+		complex product[4] = { 1.0 };
+		for (index j = 0; j < 4; j++) {
+			if (j == k) {
+				continue;
+			}
+			for (index i = 3; i >= 1; i--) {
+				product[i] -= poles[j] * product[i - 1];
+			}
+		}
+		for (index i = 0; i < 4; i++) {
+			numerator[i] += weights[k] * product[i];
+		}
+	}
+
+	Coefficients result;
+	for (index i = 0; i < 4; i++) {
+		result.causal[i] = numerator[i].real();
+		result.feedback[i] = denominator[i + 1].real();
+	}
+
+	// Anti-causal part is h(n) for n >= 1 mirrored, which is causal part without h(0):
+	// its numerator is (numerator - h(0) * denominator) with z instead of z^-1
+	for (index i = 0; i < 4; i++) {
+		const double causalCoefficient = i + 1 < 4 ? result.causal[i + 1] : 0.0;
+		result.antiCausal[i] = causalCoefficient - result.causal[0] * result.feedback[i];
+	}
+
+	// sum of h(n) over all n, which is sum of coefficients of both parts for z = 1
+	double causalSum = 0.0;
+	double antiCausalSum = 0.0;
+	double denominatorSum = 1.0;
+	for (index i = 0; i < 4; i++) {
+		causalSum += result.causal[i];
+		antiCausalSum += result.antiCausal[i];
+		denominatorSum += result.feedback[i];
+	}
+	result.normalization = denominatorSum / (causalSum + antiCausalSum);
+
+	return result;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <array>
+
+namespace rxtd::audio_utils {
+	// Approximates gaussian blur with 4th order recursive filter from
+	// R. Deriche, "Recursively implementing the Gaussian and its derivatives", 1993.
+	// Cost doesn't depend on blur radius.
+	//
+	// Filter is a sum of causal and anti-causal parts, which are calculated independently,
+	// so starting each of them from zero state is the same as treating values outside of source as zero,
+	// just like GaussianCoefficientsManager kernel does.
+	// Radius has the same meaning as in GaussianCoefficientsManager, sigma is radius / 3,
+	// but recursive filter isn't truncated, so it has small tails outside of radius.
+	class RecursiveGaussian {
+		struct Coefficients {
+			// causal part:      y[n] = sum(causal[i] * x[n - i]) - sum(feedback[i] * y[n - 1 - i])
+			// anti-causal part: y[n] = sum(antiCausal[i] * x[n + 1 + i]) - sum(feedback[i] * y[n + 1 + i])
+			std::array<double, 4> causal{ };
+			std::array<double, 4> antiCausal{ };
+			std::array<double, 4> feedback{ };
+			double normalization{ };
+		};
+
+		// radius -> coefficients
+		std::map<index, Coefficients> coefficients;
+
+		std::vector<double> causalResult;
+
+	public:
+		void apply(array_view<float> source, array_span<float> dest, index radius);
+
+	private:
+		const Coefficients& getCoefficients(index radius);
+
+		[[nodiscard]]
+		static Coefficients calculateCoefficients(double sigma);
+	};
+}
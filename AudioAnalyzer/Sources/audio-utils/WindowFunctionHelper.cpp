@@ -13,6 +13,7 @@
 #include "option-parser/OptionList.h"
 #include "option-parser/OptionSequence.h"
 #include "cheby_win-lib/cheby_win.h"
+#include "SharedCache.h"
 
 using namespace audio_utils;
 
@@ -71,6 +72,14 @@ WindowFunctionHelper::WindowCreationFunc WindowFunctionHelper::parse(sview desc,
 // Windows are asymmetric, so I use "i / size" everywhere instead of "* i / (size - 1)"
 //
 
+std::shared_ptr<const std::vector<float>> WindowFunctionHelper::getShared(
+	sview desc, index size,
+	const WindowCreationFunc& wcf
+) {
+	static utils::SharedCache<std::pair<string, index>, std::vector<float>> cache;
+	return cache.get({ desc % own(), size }, [&] { return wcf(size); });
+}
+
 std::vector<float> WindowFunctionHelper::createRectangular(index size) {
 	std::vector<float> window;
 	window.resize(size);
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <functional>
+#include <memory>
 #include "RainmeterWrappers.h"
 
 namespace rxtd::audio_utils {
@@ -20,6 +21,11 @@ namespace rxtd::audio_utils {
 
 		static WindowCreationFunc parse(sview desc, utils::Rainmeter::Logger& cl);
 
+		// Windows are immutable, so all users with the same #desc and #size get the same vector.
+		// #wcf must be the result of #parse(desc).
+		[[nodiscard]]
+		static std::shared_ptr<const std::vector<float>> getShared(sview desc, index size, const WindowCreationFunc& wcf);
+
 		[[nodiscard]]
 		static std::vector<float> createRectangular(index size);
 
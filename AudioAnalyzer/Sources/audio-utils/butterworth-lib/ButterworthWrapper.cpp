@@ -9,13 +9,149 @@
 
 #include "ButterworthWrapper.h"
 #include "iir.h"
+#include <complex>
 
 using namespace audio_utils;
 
 using BW = ButterworthWrapper;
 using GCC = BW::GenericCoefCalculator;
 
-const GCC BW::lowPass = { dcof_bwlp, ccof_bwlp, sf_bwlp, oneSideSlopeSize };
-const GCC BW::highPass = { dcof_bwhp, ccof_bwhp, sf_bwhp, oneSideSlopeSize };
-const GCC BW::bandPass = { dcof_bwbp, ccof_bwbp, sf_bwbp, twoSideSlopeSize };
-const GCC BW::bandStop = { dcof_bwbs, ccof_bwbs, sf_bwbs, twoSideSlopeSize };
+const GCC BW::lowPass = { dcof_bwlp, ccof_bwlp, sf_bwlp, oneSideSlopeSize, lowPassSections };
+const GCC BW::highPass = { dcof_bwhp, ccof_bwhp, sf_bwhp, oneSideSlopeSize, highPassSections };
+const GCC BW::bandPass = { dcof_bwbp, ccof_bwbp, sf_bwbp, twoSideSlopeSize, bandPassSections };
+const GCC BW::bandStop = { dcof_bwbs, ccof_bwbs, sf_bwbs, twoSideSlopeSize, bandStopSections };
+
+// Sections are calculated from poles of analog prototype filter,
+// and never go through polynomial form, which loses precision at high orders.
+// Analog filter is converted into digital with bilinear transform,
+// so frequencies are prewarped the same way as in iir.cpp.
+
+namespace {
+	using complex = std::complex<double>;
+
+	// numerator of the section, in the same order as BiQuadCoefficients
+	struct Zeros {
+		double b0;
+		double b1;
+		double b2;
+	};
+
+	// pole of analog prototype lowpass filter with cutoff at 1 rad/s
+	// poles with index < order / 2 have positive imaginary part,
+	// pole with index (order - 1) / 2 is real when order is odd
+	complex prototypePole(index order, index k) {
+		const double angle = utils::MyMath::pi * double(2 * k + order + 1) / double(2 * order);
+		return std::polar(1.0, angle);
+	}
+
+	double prewarp(double digitalFrequency) {
+		return std::tan(utils::MyMath::pi * digitalFrequency * 0.5);
+	}
+
+	complex bilinear(complex analogPole) {
+		return (1.0 + analogPole) / (1.0 - analogPole);
+	}
+
+	// poles must be either a conjugate pair or both real
+	// gain is normalized so that section has unit gain at the point #normalizationPoint
+	BiQuadCoefficients makeSection(complex pole1, complex pole2, Zeros zeros, complex normalizationPoint) {
+		BiQuadCoefficients result;
+		result.a1 = -(pole1 + pole2).real();
+		result.a2 = (pole1 * pole2).real();
+
+		const complex z1 = 1.0 / normalizationPoint;
+		const complex z2 = z1 * z1;
+		const double gain = std::abs(1.0 + result.a1 * z1 + result.a2 * z2) / std::abs(zeros.b0 + zeros.b1 * z1 + zeros.b2 * z2);
+
+		result.b0 = zeros.b0 * gain;
+		result.b1 = zeros.b1 * gain;
+		result.b2 = zeros.b2 * gain;
+		return result;
+	}
+
+	// first order section with one real pole
+	BiQuadCoefficients makeSection(complex pole, Zeros zeros, complex normalizationPoint) {
+		BiQuadCoefficients result;
+		result.a1 = -pole.real();
+		result.a2 = 0.0;
+
+		const complex z1 = 1.0 / normalizationPoint;
+		const double gain = std::abs(1.0 + result.a1 * z1) / std::abs(zeros.b0 + zeros.b1 * z1);
+
+		result.b0 = zeros.b0 * gain;
+		result.b1 = zeros.b1 * gain;
+		result.b2 = 0.0;
+		return result;
+	}
+
+	// lowpass and highpass filters have one pole per order
+	SecondOrderSections oneSideSlopeSections(index order, bool highPass, double cutoff) {
+		const double warped = prewarp(cutoff);
+		const auto transform = [=](complex prototype) {
+			return highPass ? warped / prototype : warped * prototype;
+		};
+		const Zeros pairZeros = highPass ? Zeros{ 1.0, -2.0, 1.0 } : Zeros{ 1.0, 2.0, 1.0 };
+		const Zeros singleZeros = highPass ? Zeros{ 1.0, -1.0, 0.0 } : Zeros{ 1.0, 1.0, 0.0 };
+		const complex normalizationPoint = highPass ? -1.0 : 1.0;
+
+		SecondOrderSections result;
+		for (index k = 0; k < order / 2; k++) {
+			const complex pole = bilinear(transform(prototypePole(order, k)));
+			result.sections.push_back(makeSection(pole, std::conj(pole), pairZeros, normalizationPoint));
+		}
+		if (order % 2 != 0) {
+			const complex pole = bilinear(transform(prototypePole(order, order / 2)));
+			result.sections.push_back(makeSection(pole, singleZeros, normalizationPoint));
+		}
+		return result;
+	}
+
+	// bandpass and bandstop filters have two poles per order
+	SecondOrderSections twoSideSlopeSections(index order, bool bandStop, double cutoffLow, double cutoffHigh) {
+		const double warpedLow = prewarp(cutoffLow);
+		const double warpedHigh = prewarp(cutoffHigh);
+		const double centerSquared = warpedLow * warpedHigh;
+		const double bandwidth = warpedHigh - warpedLow;
+
+		// each prototype pole p turns into two roots of s^2 - c * s + centerSquared
+		// where c == p * bandwidth for bandpass and c == bandwidth / p for bandstop
+		const auto transform = [=](complex prototype) {
+			const complex c = bandStop ? bandwidth / prototype : prototype * bandwidth;
+			const complex root = std::sqrt(c * c - 4.0 * centerSquared);
+			return std::pair{ bilinear((c + root) * 0.5), bilinear((c - root) * 0.5) };
+		};
+
+		const double centerCos = (1.0 - centerSquared) / (1.0 + centerSquared);
+		const Zeros zeros = bandStop ? Zeros{ 1.0, -2.0 * centerCos, 1.0 } : Zeros{ 1.0, 0.0, -1.0 };
+		const complex normalizationPoint = bandStop ? 1.0 : complex{ centerCos, std::sqrt(1.0 - centerCos * centerCos) };
+
+		SecondOrderSections result;
+		for (index k = 0; k < order / 2; k++) {
+			const auto [pole1, pole2] = transform(prototypePole(order, k));
+			result.sections.push_back(makeSection(pole1, std::conj(pole1), zeros, normalizationPoint));
+			result.sections.push_back(makeSection(pole2, std::conj(pole2), zeros, normalizationPoint));
+		}
+		if (order % 2 != 0) {
+			// real prototype pole gives either two real poles or a conjugate pair
+			const auto [pole1, pole2] = transform(prototypePole(order, order / 2));
+			result.sections.push_back(makeSection(pole1, pole2, zeros, normalizationPoint));
+		}
+		return result;
+	}
+}
+
+SecondOrderSections BW::lowPassSections(index order, double cutoff, double unused) {
+	return oneSideSlopeSections(order, false, cutoff);
+}
+
+SecondOrderSections BW::highPassSections(index order, double cutoff, double unused) {
+	return oneSideSlopeSections(order, true, cutoff);
+}
+
+SecondOrderSections BW::bandPassSections(index order, double cutoffLow, double cutoffHigh) {
+	return twoSideSlopeSections(order, false, cutoffLow, cutoffHigh);
+}
+
+SecondOrderSections BW::bandStopSections(index order, double cutoffLow, double cutoffHigh) {
+	return twoSideSlopeSections(order, true, cutoffLow, cutoffHigh);
+}
@@ -9,6 +9,7 @@
 
 #pragma once
 #include "../filter-utils/InfiniteResponseFilter.h"
+#include "../filter-utils/SecondOrderSections.h"
 
 namespace rxtd::audio_utils {
 	class ButterworthWrapper {
@@ -21,16 +22,19 @@ namespace rxtd::audio_utils {
 		class GenericCoefCalculator {
 			using CoefFuncSignature = double* (*)(int order, double f1, double f2);
 			using ScalingFuncSignature = double (*)(int n, double f1, double f2);
+			using SectionsFuncSignature = SecondOrderSections (*)(index order, double f1, double f2);
 
 			const CoefFuncSignature aFunc;
 			const CoefFuncSignature bFunc;
 			const ScalingFuncSignature sFunc;
 			const SizeFuncSignature sizeFunc;
+			const SectionsFuncSignature sectionsFunc;
 
 		public:
 			GenericCoefCalculator(
-				CoefFuncSignature aFunc, CoefFuncSignature bFunc, ScalingFuncSignature sFunc, SizeFuncSignature sizeFunc
-			) : aFunc(aFunc), bFunc(bFunc), sFunc(sFunc), sizeFunc(sizeFunc) {
+				CoefFuncSignature aFunc, CoefFuncSignature bFunc, ScalingFuncSignature sFunc, SizeFuncSignature sizeFunc,
+				SectionsFuncSignature sectionsFunc
+			) : aFunc(aFunc), bFunc(bFunc), sFunc(sFunc), sizeFunc(sizeFunc), sectionsFunc(sectionsFunc) {
 			}
 
 			[[nodiscard]]
@@ -80,6 +84,32 @@ namespace rxtd::audio_utils {
 				);
 			}
 
+			// same filter as #calcCoefDigital, but split into biquad sections
+			[[nodiscard]]
+			SecondOrderSections calcSectionsDigital(index order, double digitalCutoffLow, double digitalCutoffHigh) const {
+				if (order <= 0) {
+					return { };
+				}
+
+				digitalCutoffLow = std::clamp(digitalCutoffLow, 0.01, 1.0 - 0.01);
+				digitalCutoffHigh = std::clamp(digitalCutoffHigh, 0.01, 1.0 - 0.01);
+
+				return sectionsFunc(order, digitalCutoffLow, digitalCutoffHigh);
+			}
+
+			[[nodiscard]]
+			SecondOrderSections calcSections(
+				index order,
+				double samplingFrequency,
+				double lowerCutoffFrequency, double upperCutoffFrequency
+			) const {
+				return calcSectionsDigital(
+					order,
+					2.0 * lowerCutoffFrequency / samplingFrequency,
+					2.0 * upperCutoffFrequency / samplingFrequency
+				);
+			}
+
 		private:
 			template <typename T, typename... Args>
 			[[nodiscard]]
@@ -111,5 +141,11 @@ namespace rxtd::audio_utils {
 		static const GenericCoefCalculator highPass;
 		static const GenericCoefCalculator bandPass;
 		static const GenericCoefCalculator bandStop;
+
+	private:
+		static SecondOrderSections lowPassSections(index order, double cutoff, double unused);
+		static SecondOrderSections highPassSections(index order, double cutoff, double unused);
+		static SecondOrderSections bandPassSections(index order, double cutoffLow, double cutoffHigh);
+		static SecondOrderSections bandStopSections(index order, double cutoffLow, double cutoffHigh);
 	};
 }
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "KissFftBackend.h"
+
+using namespace audio_utils;
+
+void KissFftBackend::setSize(index size) {
+	// transform uses internal scratch buffer, so each backend needs its own instance,
+	// but twiddles only need to be computed once
+	static utils::SharedCache<index, FftImpl> prototypeCache;
+	prototype = prototypeCache.get(size, [size] {
+		FftImpl result;
+		result.assign(size / 2, false);
+		return result;
+	});
+	kiss = *prototype;
+
+	inputBuffer.resize(size);
+	outputBuffer.resize(size / 2);
+	real.resize(size / 2);
+	imag.resize(size / 2);
+}
+
+void KissFftBackend::process(array_view<float> wave, array_view<float> window) {
+	const index size = index(inputBuffer.size());
+	for (index i = 0; i < size; ++i) {
+		inputBuffer[i] = wave[i] * window[i];
+	}
+
+	kiss.transform_real(inputBuffer.data(), outputBuffer.data());
+
+	for (index i = 0; i < index(outputBuffer.size()); ++i) {
+		real[i] = outputBuffer[i].real();
+		imag[i] = outputBuffer[i].imag();
+	}
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "../FFT.h"
+#include "../kiss_fft-lib/KissFft.hh"
+#include "SharedCache.h"
+
+namespace rxtd::audio_utils {
+	// Scalar implementation, supports any even size
+	class KissFftBackend : public FftBackend {
+		using FftImpl = kiss_fft::KissFft<float>;
+
+		// cache only holds weak references, so prototype must be kept alive
+		// for other backends of the same size to find it
+		std::shared_ptr<const FftImpl> prototype;
+		FftImpl kiss;
+
+		// need separate input buffer because of window application
+		std::vector<FftImpl::scalar_type> inputBuffer;
+		std::vector<FftImpl::complex_type> outputBuffer;
+
+		std::vector<float> real;
+		std::vector<float> imag;
+
+	public:
+		void setSize(index size) override;
+
+		void process(array_view<float> wave, array_view<float> window) override;
+
+		[[nodiscard]]
+		array_view<float> getReal() const override {
+			return real;
+		}
+
+		[[nodiscard]]
+		array_view<float> getImag() const override {
+			return imag;
+		}
+	};
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "StockhamFftBackend.h"
+#include <cmath>
+#include <emmintrin.h>
+
+using namespace audio_utils;
+
+namespace {
+	// Butterflies are written once for both float and Vector4,
+	// these overloads are the only difference between scalar and vector code
+
+	// __m128 is wrapped because its alignment attribute is dropped when it is used as a template argument
+	struct Vector4 {
+		__m128 value;
+	};
+
+	inline void load(const float* ptr, float& value) {
+		value = *ptr;
+	}
+
+	inline void load(const float* ptr, Vector4& value) {
+		value.value = _mm_loadu_ps(ptr);
+	}
+
+	inline void store(float* ptr, float value) {
+		*ptr = value;
+	}
+
+	inline void store(float* ptr, Vector4 value) {
+		_mm_storeu_ps(ptr, value.value);
+	}
+
+	inline void splat(float source, float& value) {
+		value = source;
+	}
+
+	inline void splat(float source, Vector4& value) {
+		value.value = _mm_set1_ps(source);
+	}
+
+	inline float add(float a, float b) {
+		return a + b;
+	}
+
+	inline Vector4 add(Vector4 a, Vector4 b) {
+		return { _mm_add_ps(a.value, b.value) };
+	}
+
+	inline float sub(float a, float b) {
+		return a - b;
+	}
+
+	inline Vector4 sub(Vector4 a, Vector4 b) {
+		return { _mm_sub_ps(a.value, b.value) };
+	}
+
+	inline float mul(float a, float b) {
+		return a * b;
+	}
+
+	inline Vector4 mul(Vector4 a, Vector4 b) {
+		return { _mm_mul_ps(a.value, b.value) };
+	}
+
+	template<typename T>
+	struct Complex {
+		T re;
+		T im;
+	};
+
+	template<typename T>
+	Complex<T> operator+(Complex<T> a, Complex<T> b) {
+		return { add(a.re, b.re), add(a.im, b.im) };
+	}
+
+	template<typename T>
+	Complex<T> operator-(Complex<T> a, Complex<T> b) {
+		return { sub(a.re, b.re), sub(a.im, b.im) };
+	}
+
+	template<typename T>
+	Complex<T> operator*(Complex<T> a, Complex<T> b) {
+		return { sub(mul(a.re, b.re), mul(a.im, b.im)), add(mul(a.re, b.im), mul(a.im, b.re)) };
+	}
+
+	template<typename T>
+	Complex<T> scale(Complex<T> a, T value) {
+		return { mul(a.re, value), mul(a.im, value) };
+	}
+
+	// returns pair (a - i*b, a + i*b)
+	template<typename T>
+	void rotateSum(Complex<T> a, Complex<T> b, Complex<T>& minus, Complex<T>& plus) {
+		minus = { add(a.re, b.im), sub(a.im, b.re) };
+		plus = { sub(a.re, b.im), add(a.im, b.re) };
+	}
+
+	template<index radix, typename T>
+	void dft(Complex<T>* values) {
+		if constexpr (radix == 2) {
+			const auto a0 = values[0];
+			const auto a1 = values[1];
+			values[0] = a0 + a1;
+			values[1] = a0 - a1;
+		} else if constexpr (radix == 3) {
+			T half;
+			splat(0.5f, half);
+			T sin60;
+			splat(0.86602540378443864676f, sin60);
+
+			const auto a0 = values[0];
+			const auto sum = values[1] + values[2];
+			const auto diff = scale(values[1] - values[2], sin60);
+			const auto base = a0 - scale(sum, half);
+
+			values[0] = a0 + sum;
+			rotateSum(base, diff, values[1], values[2]);
+		} else if constexpr (radix == 4) {
+			const auto s02 = values[0] + values[2];
+			const auto d02 = values[0] - values[2];
+			const auto s13 = values[1] + values[3];
+			const auto d13 = values[1] - values[3];
+
+			values[0] = s02 + s13;
+			values[2] = s02 - s13;
+			rotateSum(d02, d13, values[1], values[3]);
+		} else if constexpr (radix == 5) {
+			T c1, c2, s1, s2;
+			splat(0.30901699437494742410f, c1);  // cos(2pi/5)
+			splat(-0.80901699437494742410f, c2); // cos(4pi/5)
+			splat(0.95105651629515357212f, s1);  // sin(2pi/5)
+			splat(0.58778525229247312917f, s2);  // sin(4pi/5)
+
+			const auto a0 = values[0];
+			const auto b1 = values[1] + values[4];
+			const auto b2 = values[2] + values[3];
+			const auto d1 = values[1] - values[4];
+			const auto d2 = values[2] - values[3];
+
+			const auto t1 = a0 + scale(b1, c1) + scale(b2, c2);
+			const auto t2 = a0 + scale(b1, c2) + scale(b2, c1);
+			const auto u1 = scale(d1, s1) + scale(d2, s2);
+			const auto u2 = scale(d1, s2) - scale(d2, s1);
+
+			values[0] = a0 + b1 + b2;
+			rotateSum(t1, u1, values[1], values[4]);
+			rotateSum(t2, u2, values[2], values[3]);
+		}
+	}
+
+	// One column of a Stockham stage:
+	// y[q + s*(r*p + k)] = w^(p*k) * sum_j x[q + s*(p + j*m)] * exp(-2*pi*i*j*k/r)
+	template<index radix, typename T>
+	void butterfly(
+		const float* xr, const float* xi, float* yr, float* yi,
+		index s, index m, index p, index q,
+		const Complex<T>* twiddles
+	) {
+		Complex<T> values[radix];
+		for (index j = 0; j < radix; ++j) {
+			const index i = q + s * (p + j * m);
+			load(xr + i, values[j].re);
+			load(xi + i, values[j].im);
+		}
+
+		dft<radix>(values);
+
+		for (index k = 1; k < radix; ++k) {
+			values[k] = values[k] * twiddles[k - 1];
+		}
+
+		for (index k = 0; k < radix; ++k) {
+			const index i = q + s * (radix * p + k);
+			store(yr + i, values[k].re);
+			store(yi + i, values[k].im);
+		}
+	}
+
+	template<index radix>
+	void runStage(
+		const float* xr, const float* xi, float* yr, float* yi,
+		index s, index m,
+		const float* twr, const float* twi
+	) {
+		for (index p = 0; p < m; ++p) {
+			Complex<float> scalarTwiddles[radix - 1];
+			Complex<Vector4> vectorTwiddles[radix - 1];
+			for (index k = 0; k < radix - 1; ++k) {
+				scalarTwiddles[k] = { twr[k], twi[k] };
+				vectorTwiddles[k] = { { _mm_set1_ps(twr[k]) }, { _mm_set1_ps(twi[k]) } };
+			}
+			twr += radix - 1;
+			twi += radix - 1;
+
+			index q = 0;
+			for (; q + 4 <= s; q += 4) {
+				butterfly<radix>(xr, xi, yr, yi, s, m, p, q, vectorTwiddles);
+			}
+			for (; q < s; ++q) {
+				butterfly<radix>(xr, xi, yr, yi, s, m, p, q, scalarTwiddles);
+			}
+		}
+	}
+}
+
+bool StockhamFftBackend::isSizeSupported(index size) {
+	if (size % 2 != 0 || size < 32) {
+		return false;
+	}
+
+	index n = size / 2;
+	for (const index factor : { 2, 3, 5 }) {
+		while (n % factor == 0) {
+			n /= factor;
+		}
+	}
+
+	return n == 1;
+}
+
+void StockhamFftBackend::setSize(index size) {
+	static utils::SharedCache<index, Plan> planCache;
+	plan = planCache.get(size, [size] { return createPlan(size); });
+
+	halfSize = size / 2;
+	for (index i = 0; i < 2; ++i) {
+		bufferReal[i].resize(halfSize);
+		bufferImag[i].resize(halfSize);
+	}
+	real.resize(halfSize);
+	imag.resize(halfSize);
+}
+
+StockhamFftBackend::Plan StockhamFftBackend::createPlan(index size) {
+	constexpr double pi = 3.14159265358979323846;
+
+	const index halfSize = size / 2;
+	Plan plan;
+
+	std::vector<index> radixes;
+	index remaining = halfSize;
+	// big radixes first: stride grows faster, so that more stages are vectorized
+	for (const index radix : { 4, 2, 3, 5 }) {
+		while (remaining % radix == 0) {
+			radixes.push_back(radix);
+			remaining /= radix;
+		}
+	}
+
+	index n = halfSize;
+	index stride = 1;
+	for (const index radix : radixes) {
+		Stage stage;
+		stage.radix = radix;
+		stage.stride = stride;
+		stage.count = n / radix;
+		stage.twiddlesOffset = index(plan.twiddlesReal.size());
+
+		for (index p = 0; p < stage.count; ++p) {
+			for (index k = 1; k < radix; ++k) {
+				const double angle = -2.0 * pi * double(p * k) / double(n);
+				plan.twiddlesReal.push_back(float(std::cos(angle)));
+				plan.twiddlesImag.push_back(float(std::sin(angle)));
+			}
+		}
+
+		plan.stages.push_back(stage);
+
+		n /= radix;
+		stride *= radix;
+	}
+
+	plan.postTwiddlesReal.resize(halfSize);
+	plan.postTwiddlesImag.resize(halfSize);
+	for (index k = 0; k < halfSize; ++k) {
+		const double angle = -2.0 * pi * double(k) / double(size);
+		plan.postTwiddlesReal[k] = float(0.5 * std::cos(angle));
+		plan.postTwiddlesImag[k] = float(0.5 * std::sin(angle));
+	}
+
+	return plan;
+}
+
+void StockhamFftBackend::process(array_view<float> wave, array_view<float> window) {
+	splitInput(wave, window);
+	const index resultIndex = runStages();
+	postProcess(bufferReal[resultIndex].data(), bufferImag[resultIndex].data());
+}
+
+void StockhamFftBackend::splitInput(array_view<float> wave, array_view<float> window) {
+	float* zr = bufferReal[0].data();
+	float* zi = bufferImag[0].data();
+
+	index k = 0;
+	for (; k + 4 <= halfSize; k += 4) {
+		const __m128 v0 = _mm_mul_ps(_mm_loadu_ps(&wave[k * 2]), _mm_loadu_ps(&window[k * 2]));
+		const __m128 v1 = _mm_mul_ps(_mm_loadu_ps(&wave[k * 2 + 4]), _mm_loadu_ps(&window[k * 2 + 4]));
+		_mm_storeu_ps(zr + k, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(zi + k, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+	for (; k < halfSize; ++k) {
+		zr[k] = wave[k * 2] * window[k * 2];
+		zi[k] = wave[k * 2 + 1] * window[k * 2 + 1];
+	}
+}
+
+index StockhamFftBackend::runStages() {
+	index current = 0;
+
+	for (const auto& stage : plan->stages) {
+		const float* xr = bufferReal[current].data();
+		const float* xi = bufferImag[current].data();
+		float* yr = bufferReal[1 - current].data();
+		float* yi = bufferImag[1 - current].data();
+		const float* twr = plan->twiddlesReal.data() + stage.twiddlesOffset;
+		const float* twi = plan->twiddlesImag.data() + stage.twiddlesOffset;
+
+		switch (stage.radix) {
+		case 2:
+			runStage<2>(xr, xi, yr, yi, stage.stride, stage.count, twr, twi);
+			break;
+		case 3:
+			runStage<3>(xr, xi, yr, yi, stage.stride, stage.count, twr, twi);
+			break;
+		case 4:
+			runStage<4>(xr, xi, yr, yi, stage.stride, stage.count, twr, twi);
+			break;
+		case 5:
+			runStage<5>(xr, xi, yr, yi, stage.stride, stage.count, twr, twi);
+			break;
+		default: ;
+		}
+
+		current = 1 - current;
+	}
+
+	return current;
+}
+
+void StockhamFftBackend::postProcess(const float* zr, const float* zi) {
+	// see KissFft::transform_real
+	// X[k] = (Z[k] + conj(Z[N-k])) / 2 - i * exp(-2*pi*i*k/2N) * (Z[k] - conj(Z[N-k])) / 2
+
+	real[0] = zr[0] + zi[0];
+	imag[0] = zr[0] - zi[0];
+
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	index k = 1;
+	for (; k + 4 <= halfSize; k += 4) {
+		const index mirror = halfSize - k - 3;
+
+		const __m128 ar = _mm_loadu_ps(zr + k);
+		const __m128 ai = _mm_loadu_ps(zi + k);
+		__m128 br = _mm_loadu_ps(zr + mirror);
+		__m128 bi = _mm_loadu_ps(zi + mirror);
+		br = _mm_shuffle_ps(br, br, _MM_SHUFFLE(0, 1, 2, 3));
+		bi = _mm_shuffle_ps(bi, bi, _MM_SHUFFLE(0, 1, 2, 3));
+
+		const __m128 c = _mm_loadu_ps(plan->postTwiddlesReal.data() + k);
+		const __m128 s = _mm_loadu_ps(plan->postTwiddlesImag.data() + k);
+
+		const __m128 sumR = _mm_add_ps(ar, br);
+		const __m128 diffR = _mm_sub_ps(ar, br);
+		const __m128 sumI = _mm_add_ps(ai, bi);
+		const __m128 diffI = _mm_sub_ps(ai, bi);
+
+		const __m128 resultR = _mm_add_ps(
+			_mm_mul_ps(half, sumR),
+			_mm_add_ps(_mm_mul_ps(c, sumI), _mm_mul_ps(s, diffR))
+		);
+		const __m128 resultI = _mm_add_ps(
+			_mm_mul_ps(half, diffI),
+			_mm_sub_ps(_mm_mul_ps(s, sumI), _mm_mul_ps(c, diffR))
+		);
+
+		_mm_storeu_ps(real.data() + k, resultR);
+		_mm_storeu_ps(imag.data() + k, resultI);
+	}
+	for (; k < halfSize; ++k) {
+		const index mirror = halfSize - k;
+
+		const float c = plan->postTwiddlesReal[k];
+		const float s = plan->postTwiddlesImag[k];
+
+		const float sumR = zr[k] + zr[mirror];
+		const float diffR = zr[k] - zr[mirror];
+		const float sumI = zi[k] + zi[mirror];
+		const float diffI = zi[k] - zi[mirror];
+
+		real[k] = 0.5f * sumR + c * sumI + s * diffR;
+		imag[k] = 0.5f * diffI + s * sumI - c * diffR;
+	}
+}
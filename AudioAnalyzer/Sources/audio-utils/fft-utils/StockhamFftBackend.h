@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "../FFT.h"
+#include "SharedCache.h"
+
+namespace rxtd::audio_utils {
+	// Mixed radix (2, 3, 4, 5) Stockham autosort transform.
+	// Data is stored as separate real and imaginary arrays,
+	// so that butterflies of 4 consecutive sub-transforms can be computed at once with SSE2.
+	// Real input is handled as complex of half size with post processing.
+	// Window multiplication is done together with splitting input into even and odd samples.
+	class StockhamFftBackend : public FftBackend {
+		struct Stage {
+			index radix{ };
+			index stride{ };
+			index count{ };
+			index twiddlesOffset{ };
+		};
+
+		// immutable part of the transform, shared between all backends of the same size
+		struct Plan {
+			std::vector<Stage> stages;
+
+			// for each stage for each sub-transform radix-1 values
+			std::vector<float> twiddlesReal;
+			std::vector<float> twiddlesImag;
+
+			// already multiplied by 0.5
+			std::vector<float> postTwiddlesReal;
+			std::vector<float> postTwiddlesImag;
+		};
+
+		index halfSize{ };
+		std::shared_ptr<const Plan> plan;
+
+		std::vector<float> bufferReal[2];
+		std::vector<float> bufferImag[2];
+
+		std::vector<float> real;
+		std::vector<float> imag;
+
+	public:
+		// Size must be even and half size must only have factors 2, 3 and 5.
+		// Very small sizes aren't worth it.
+		[[nodiscard]]
+		static bool isSizeSupported(index size);
+
+		void setSize(index size) override;
+
+		void process(array_view<float> wave, array_view<float> window) override;
+
+		[[nodiscard]]
+		array_view<float> getReal() const override {
+			return real;
+		}
+
+		[[nodiscard]]
+		array_view<float> getImag() const override {
+			return imag;
+		}
+
+	private:
+		[[nodiscard]]
+		static Plan createPlan(index size);
+
+		void splitInput(array_view<float> wave, array_view<float> window);
+		// returns index of the buffer with result
+		index runStages();
+		void postProcess(const float* zReal, const float* zImag);
+	};
+}
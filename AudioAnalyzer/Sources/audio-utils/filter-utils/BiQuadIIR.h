@@ -9,6 +9,7 @@
 
 #pragma once
 #include "AbstractFilter.h"
+#include "SecondOrderSections.h"
 
 namespace rxtd::audio_utils {
 	class BiQuadIIR : public AbstractFilter {
@@ -32,5 +33,10 @@ namespace rxtd::audio_utils {
 		void apply(array_span<float> signal) override;
 
 		void addGainDbEnergy(double gainDB) override;
+
+		[[nodiscard]]
+		SecondOrderSections getSections() const {
+			return { { { b0, b1, b2, a1, a2 } }, gainAmp };
+		}
 	};
 }
@@ -8,16 +8,194 @@
  */
 
 #include "FilterCascade.h"
+#include <array>
+#include <emmintrin.h>
 
 using namespace audio_utils;
 
-void FilterCascade::apply(array_view<float> wave) {
-	wave.transferToVector(processed);
-	applyInPlace(processed);
+namespace {
+	template <typename T>
+	struct SimdTraits;
+
+	template <>
+	struct SimdTraits<float> {
+		using Vector = __m128;
+		static constexpr index width = 4;
+
+		static Vector load(const float* ptr) { return _mm_loadu_ps(ptr); }
+		static void store(float* ptr, Vector value) { _mm_storeu_ps(ptr, value); }
+		static Vector broadcast(double value) { return _mm_set1_ps(float(value)); }
+		static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+	};
+
+	template <>
+	struct SimdTraits<double> {
+		using Vector = __m128d;
+		static constexpr index width = 2;
+
+		static Vector load(const double* ptr) { return _mm_loadu_pd(ptr); }
+		static void store(double* ptr, Vector value) { _mm_storeu_pd(ptr, value); }
+		static Vector broadcast(double value) { return _mm_set1_pd(value); }
+		static Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+	};
+
+	// evaluates all sections for one sample before moving to the next one,
+	// so that signal makes only one pass through memory,
+	// and count of sections is known at compile time, so the inner loop is fully unrolled
+	template <typename T, index sectionsCount>
+	void applyFused(T* data, index length, T* state, const BiQuadCoefficients* sections) {
+		using S = SimdTraits<T>;
+		using Vector = typename S::Vector;
+		constexpr index width = S::width;
+
+		std::array<Vector, sectionsCount> b0, b1, b2, a1, a2, z1, z2;
+		for (index s = 0; s < sectionsCount; s++) {
+			b0[s] = S::broadcast(sections[s].b0);
+			b1[s] = S::broadcast(sections[s].b1);
+			b2[s] = S::broadcast(sections[s].b2);
+			a1[s] = S::broadcast(sections[s].a1);
+			a2[s] = S::broadcast(sections[s].a2);
+			z1[s] = S::load(state + s * 2 * width);
+			z2[s] = S::load(state + s * 2 * width + width);
+		}
+
+		for (index i = 0; i < length; i++) {
+			auto x = S::load(data + i * width);
+			for (index s = 0; s < sectionsCount; s++) {
+				const auto y = S::add(S::mul(x, b0[s]), z1[s]);
+				z1[s] = S::add(S::sub(S::mul(x, b1[s]), S::mul(y, a1[s])), z2[s]);
+				z2[s] = S::sub(S::mul(x, b2[s]), S::mul(y, a2[s]));
+				x = y;
+			}
+			S::store(data + i * width, x);
+		}
+
+		for (index s = 0; s < sectionsCount; s++) {
+			S::store(state + s * 2 * width, z1[s]);
+			S::store(state + s * 2 * width + width, z2[s]);
+		}
+	}
+
+	// generic version for any count of sections
+	// each section makes a separate pass through the signal
+	template <typename T>
+	void applySeparate(T* data, index length, T* state, const BiQuadCoefficients* sections, index sectionsCount) {
+		using S = SimdTraits<T>;
+		constexpr index width = S::width;
+
+		for (index section = 0; section < sectionsCount; section++) {
+			const auto& coefs = sections[section];
+			const auto b0 = S::broadcast(coefs.b0);
+			const auto b1 = S::broadcast(coefs.b1);
+			const auto b2 = S::broadcast(coefs.b2);
+			const auto a1 = S::broadcast(coefs.a1);
+			const auto a2 = S::broadcast(coefs.a2);
+
+			T* z1Ptr = state + section * 2 * width;
+			T* z2Ptr = z1Ptr + width;
+			auto z1 = S::load(z1Ptr);
+			auto z2 = S::load(z2Ptr);
+
+			for (index i = 0; i < length; i++) {
+				const auto x = S::load(data + i * width);
+				const auto y = S::add(S::mul(x, b0), z1);
+				z1 = S::add(S::sub(S::mul(x, b1), S::mul(y, a1)), z2);
+				z2 = S::sub(S::mul(x, b2), S::mul(y, a2));
+				S::store(data + i * width, y);
+			}
+
+			S::store(z1Ptr, z1);
+			S::store(z2Ptr, z2);
+		}
+	}
+
+	template <typename T>
+	using FusedKernel = void(*)(T* data, index length, T* state, const BiQuadCoefficients* sections);
+
+	// butterworth filter of order 16 needs 8 sections for lowpass and highpass and 16 sections for bandpass and bandstop
+	constexpr index maxFusedSections = 16;
+
+	template <typename T, index... indices>
+	constexpr std::array<FusedKernel<T>, sizeof...(indices)> makeFusedKernels(std::integer_sequence<index, indices...>) {
+		return { &applyFused<T, indices + 1>... };
+	}
+
+	template <typename T>
+	constexpr auto fusedKernels = makeFusedKernels<T>(std::make_integer_sequence<index, maxFusedSections>{ });
+}
+
+void FilterCascade::apply(array_view<array_span<float>> channels) {
+	if (sos.sections.empty() || channels.empty()) {
+		return;
+	}
+
+	switch (precision) {
+	case Precision::FLOAT:
+		applyImpl(channels, floatState, floatInterleaved);
+		break;
+	case Precision::DOUBLE:
+		applyImpl(channels, doubleState, doubleInterleaved);
+		break;
+	}
+}
+
+void FilterCascade::reset() {
+	floatState.clear();
+	doubleState.clear();
 }
 
-void FilterCascade::applyInPlace(array_span<float> wave) const {
-	for (const auto& filterPtr : filters) {
-		filterPtr->apply(wave);
+template <typename T>
+void FilterCascade::applyImpl(array_view<array_span<float>> channels, std::vector<T>& state, std::vector<T>& interleaved) const {
+	using S = SimdTraits<T>;
+	constexpr index width = S::width;
+
+	const index channelsCount = channels.size();
+	const index groupsCount = (channelsCount + width - 1) / width;
+	const index sectionsCount = sos.sections.size();
+	const index groupStateSize = sectionsCount * 2 * width;
+
+	if (index(state.size()) != groupsCount * groupStateSize) {
+		// number of channels has changed, old state is meaningless
+		state.clear();
+		state.resize(groupsCount * groupStateSize);
+	}
+
+	for (index group = 0; group < groupsCount; group++) {
+		const index firstChannel = group * width;
+		const index lanesCount = std::min(width, channelsCount - firstChannel);
+
+		index length = 0;
+		for (index lane = 0; lane < lanesCount; lane++) {
+			length = std::max(length, channels[firstChannel + lane].size());
+		}
+
+		// unused lanes are kept at zero
+		interleaved.clear();
+		interleaved.resize(length * width);
+		for (index lane = 0; lane < lanesCount; lane++) {
+			const auto wave = channels[firstChannel + lane];
+			for (index i = 0; i < wave.size(); i++) {
+				interleaved[i * width + lane] = T(wave[i]);
+			}
+		}
+
+		T* groupState = state.data() + group * groupStateSize;
+		if (sectionsCount <= maxFusedSections) {
+			fusedKernels<T>[sectionsCount - 1](interleaved.data(), length, groupState, sos.sections.data());
+		} else {
+			applySeparate(interleaved.data(), length, groupState, sos.sections.data(), sectionsCount);
+		}
+
+		const T gain = T(sos.gainAmp);
+		for (index lane = 0; lane < lanesCount; lane++) {
+			auto wave = channels[firstChannel + lane];
+			for (index i = 0; i < wave.size(); i++) {
+				wave[i] = float(interleaved[i * width + lane] * gain);
+			}
+		}
 	}
 }
@@ -8,33 +8,53 @@
  */
 
 #pragma once
-#include "InfiniteResponseFilter.h"
+#include "SecondOrderSections.h"
 
 namespace rxtd::audio_utils {
+	// Chain of biquad sections in transposed direct form II
+	// that filters several channels at once.
+	//
+	// Channels are interleaved, so that each section is evaluated
+	// for 4 channels (float precision) or 2 channels (double precision) with one SIMD instruction.
 	class FilterCascade {
-		std::vector<std::unique_ptr<AbstractFilter>> filters;
+	public:
+		enum class Precision {
+			FLOAT,
+			DOUBLE,
+		};
+
+	private:
+		SecondOrderSections sos;
+		Precision precision = Precision::DOUBLE;
 
-		std::vector<float> processed;
+		// [group of channels][section][z1 or z2][channel in group]
+		std::vector<float> floatState;
+		std::vector<double> doubleState;
+
+		// [sample][channel in group]
+		std::vector<float> floatInterleaved;
+		std::vector<double> doubleInterleaved;
 
 	public:
 		FilterCascade() = default;
 
-		FilterCascade(std::vector<std::unique_ptr<AbstractFilter>> filters) :
-			filters(std::move(filters)) {
+		FilterCascade(SecondOrderSections sos, Precision precision) :
+			sos(std::move(sos)), precision(precision) {
 		}
 
-		void apply(array_view<float> wave);
+		// filters each channel in place
+		// channels may have different sizes, but they are expected to be equal
+		void apply(array_view<array_span<float>> channels);
 
-		void applyInPlace(array_span<float> wave) const;
-
-		[[nodiscard]]
-		array_view<float> getProcessed() const {
-			return processed;
-		}
+		void reset();
 
 		[[nodiscard]]
 		bool isEmpty() const {
-			return filters.empty();
+			return sos.sections.empty();
 		}
+
+	private:
+		template <typename T>
+		void applyImpl(array_view<array_span<float>> channels, std::vector<T>& state, std::vector<T>& interleaved) const;
 	};
 }
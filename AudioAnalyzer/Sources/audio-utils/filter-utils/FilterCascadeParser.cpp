@@ -8,7 +8,6 @@
  */
 
 #include "FilterCascadeParser.h"
-#include "InfiniteResponseFilter.h"
 #include "BiQuadIIR.h"
 #include "BQFilterBuilder.h"
 #include "RainmeterWrappers.h"
@@ -18,13 +17,13 @@
 
 using namespace audio_utils;
 
-FilterCascade FilterCascadeCreator::getInstance(double samplingFrequency) const {
-	std::vector<std::unique_ptr<AbstractFilter>> result;
+FilterCascade FilterCascadeCreator::getInstance(double samplingFrequency, FilterCascade::Precision precision) const {
+	SecondOrderSections result;
 	for (const auto& patcher : patchers) {
-		result.push_back(patcher(samplingFrequency));
+		result.append(patcher(samplingFrequency));
 	}
 
-	FilterCascade fc{ std::move(result) };
+	FilterCascade fc{ std::move(result), precision };
 	return fc;
 }
 
@@ -128,13 +127,12 @@ FilterCascadeParser::parseBQ(isview name, const utils::OptionMap& description, u
 	}
 
 	return [=](double sampleFrequency) {
-		auto filter = new BiQuadIIR{ };
-		*filter = filterCreationFunc(sampleFrequency, q, centralFrequency, gain);
+		auto filter = filterCreationFunc(sampleFrequency, q, centralFrequency, gain);
 		if (gain > 0.0) {
-			filter->addGainDbEnergy(-gain);
+			filter.addGainDbEnergy(-gain);
 		}
-		filter->addGainDbEnergy(forcedGain);
-		return std::unique_ptr<AbstractFilter>{ filter };
+		filter.addGainDbEnergy(forcedGain);
+		return filter.getSections();
 	};
 }
 
@@ -146,8 +144,8 @@ FilterCascadeParser::parseBW(isview name, const utils::OptionMap& description, u
 	}
 
 	const index order = description.get(L"order").asInt();
-	if (order <= 0 || order > 5) {
-		cl.error(L"order must be in range [1, 5] but {} found", order);
+	if (order <= 0 || order > 16) {
+		cl.error(L"order must be in range [1, 16] but {} found", order);
 		return { };
 	}
 
@@ -169,11 +167,11 @@ FilterCascadeParser::parseBW(isview name, const utils::OptionMap& description, u
 		}
 
 		if (name == L"bwLowPass") {
-			return createButterworth<ButterworthWrapper::oneSideSlopeSize>(
+			return createButterworth(
 				order, forcedGain, cutoff, 0.0, ButterworthWrapper::lowPass
 			);
 		} else {
-			return createButterworth<ButterworthWrapper::oneSideSlopeSize>(
+			return createButterworth(
 				order, forcedGain, cutoff, 0.0, ButterworthWrapper::highPass
 			);
 		}
@@ -191,11 +189,11 @@ FilterCascadeParser::parseBW(isview name, const utils::OptionMap& description, u
 		}
 
 		if (name == L"bwBandPass") {
-			return createButterworth<ButterworthWrapper::twoSideSlopeSize>(
+			return createButterworth(
 				order, forcedGain, cutoffLow, cutoffHigh, ButterworthWrapper::bandPass
 			);
 		} else {
-			return createButterworth<ButterworthWrapper::twoSideSlopeSize>(
+			return createButterworth(
 				order, forcedGain, cutoffLow, cutoffHigh, ButterworthWrapper::bandStop
 			);
 		}
@@ -205,42 +203,15 @@ FilterCascadeParser::parseBW(isview name, const utils::OptionMap& description, u
 	return { };
 }
 
-template <index size>
-FilterCascadeParser::FCF FilterCascadeParser::createButterworthMaker(
+FilterCascadeParser::FCF FilterCascadeParser::createButterworth(
 	index order, double forcedGain, double freq1,
 	double freq2,
 	const ButterworthWrapper::GenericCoefCalculator&
 	butterworthMaker
 ) {
 	return [=](double sampleFrequency) {
-		auto ptr = new InfiniteResponseFilterFixed<size>{
-			butterworthMaker.calcCoef(order, sampleFrequency, freq1, freq2)
-		};
-		ptr->addGainDbEnergy(forcedGain);
-		return std::unique_ptr<AbstractFilter>{ ptr };
+		auto sections = butterworthMaker.calcSections(order, sampleFrequency, freq1, freq2);
+		sections.addGainDbEnergy(forcedGain);
+		return sections;
 	};
 }
-
-template <ButterworthWrapper::SizeFuncSignature sizeFunc>
-FilterCascadeParser::FCF FilterCascadeParser::createButterworth(
-	index order, double forcedGain, double freq1,
-	double freq2,
-	const ButterworthWrapper::GenericCoefCalculator&
-	butterworthMaker
-) {
-	switch (order) {
-	case 1: return createButterworthMaker<sizeFunc(1)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 2: return createButterworthMaker<sizeFunc(2)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 3: return createButterworthMaker<sizeFunc(3)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 4: return createButterworthMaker<sizeFunc(4)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 5: return createButterworthMaker<sizeFunc(5)>(order, forcedGain, freq1, freq2, butterworthMaker);
-
-	default: return [=](double sampleFrequency) {
-			auto ptr = new InfiniteResponseFilter{
-				butterworthMaker.calcCoef(order, sampleFrequency, freq1, freq2)
-			};
-			ptr->addGainDbEnergy(forcedGain);
-			return std::unique_ptr<AbstractFilter>{ ptr };
-		};
-	}
-}
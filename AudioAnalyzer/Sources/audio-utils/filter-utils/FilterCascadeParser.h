@@ -9,7 +9,6 @@
 
 #pragma once
 #include <functional>
-#include "AbstractFilter.h"
 #include "FilterCascade.h"
 #include "RainmeterWrappers.h"
 #include "../butterworth-lib/ButterworthWrapper.h"
@@ -17,7 +16,7 @@
 namespace rxtd::audio_utils {
 	class FilterCascadeCreator {
 	public:
-		using FilterCreationFunction = std::function<std::unique_ptr<AbstractFilter>(double sampleFrequency)>;
+		using FilterCreationFunction = std::function<SecondOrderSections(double sampleFrequency)>;
 
 	private:
 		string source;
@@ -39,7 +38,7 @@ namespace rxtd::audio_utils {
 		}
 
 		[[nodiscard]]
-		FilterCascade getInstance(double samplingFrequency) const;
+		FilterCascade getInstance(double samplingFrequency, FilterCascade::Precision precision) const;
 	};
 
 	class FilterCascadeParser {
@@ -59,16 +58,6 @@ namespace rxtd::audio_utils {
 		[[nodiscard]]
 		static FCF parseBW(isview name, const utils::OptionMap& description, utils::Rainmeter::Logger& cl);
 
-		template <index size>
-		[[nodiscard]]
-		static FCF createButterworthMaker(
-			index order,
-			double forcedGain,
-			double freq1, double freq2,
-			const ButterworthWrapper::GenericCoefCalculator& butterworthMaker
-		);
-
-		template <ButterworthWrapper::SizeFuncSignature sizeFunc>
 		[[nodiscard]]
 		static FCF createButterworth(
 			index order,
@@ -116,18 +116,15 @@ namespace rxtd::audio_utils {
 	private:
 		double updateState(const double value) {
 			const double filtered = b[0] * value + state[0];
-
-			const index lastIndex = state.size() - 1;
-			for (index i = 0; i < lastIndex; ++i) {
-				const double ai = a[i + 1];
-				const double bi = b[i + 1];
-				const double prevState = state[i + 1];
-				state[i] = bi * value - ai * filtered + prevState;
-			}
-
-			state[lastIndex] = b[lastIndex + 1] * value - a[lastIndex + 1] * filtered;
-
+			updateStateUnrolled(value, filtered, std::make_index_sequence<order - 2>{ });
+			state[order - 2] = b[order - 1] * value - a[order - 1] * filtered;
 			return filtered;
 		}
+
+		// order is known at compile time, so the loop over state is expanded by the compiler
+		template <size_t... indices>
+		void updateStateUnrolled(const double value, const double filtered, std::index_sequence<indices...>) {
+			((state[indices] = b[indices + 1] * value - a[indices + 1] * filtered + state[indices + 1]), ...);
+		}
 	};
 }
@@ -8,6 +8,7 @@
  */
 
 #pragma once
+#include <emmintrin.h>
 
 namespace rxtd::audio_utils {
 	class LogarithmicIRF {
@@ -44,8 +45,34 @@ namespace rxtd::audio_utils {
 			return value + attackDecayConstants[(value < prev)] * delta;
 		}
 
+		// same as calling apply(dest[i], source[i]) for each element
 		void arrayApply(array_view<float> source, array_span<float> dest) const {
-			for (int i = 0; i < source.size(); ++i) {
+			const index size = source.size();
+
+			const __m128 attack = _mm_set1_ps(attackDecayConstants[0]);
+			const __m128 decay = _mm_set1_ps(attackDecayConstants[1]);
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+			const __m128 maxDelta = _mm_set1_ps(std::numeric_limits<float>::max());
+			const __m128 minDelta = _mm_set1_ps(1.0e-30f);
+
+			index i = 0;
+			for (; i + 4 <= size; i += 4) {
+				const __m128 prev = _mm_loadu_ps(dest.data() + i);
+				const __m128 value = _mm_loadu_ps(source.data() + i);
+				const __m128 delta = _mm_sub_ps(prev, value);
+
+				const __m128 isDecay = _mm_cmplt_ps(value, prev);
+				const __m128 constant = _mm_or_ps(_mm_and_ps(isDecay, decay), _mm_andnot_ps(isDecay, attack));
+				const __m128 smoothed = _mm_add_ps(value, _mm_mul_ps(constant, delta));
+
+				// false for infinities, NaNs and very small deltas
+				const __m128 absDelta = _mm_and_ps(delta, absMask);
+				const __m128 useSmoothed = _mm_and_ps(_mm_cmplt_ps(absDelta, maxDelta), _mm_cmpge_ps(absDelta, minDelta));
+
+				const __m128 result = _mm_or_ps(_mm_and_ps(useSmoothed, smoothed), _mm_andnot_ps(useSmoothed, value));
+				_mm_storeu_ps(dest.data() + i, result);
+			}
+			for (; i < size; ++i) {
 				dest[i] = apply(dest[i], source[i]);
 			}
 		}
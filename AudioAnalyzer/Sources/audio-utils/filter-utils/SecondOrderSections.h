@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "MyMath.h"
+
+namespace rxtd::audio_utils {
+	// coefficients of one biquad section, normalized so that a0 == 1
+	struct BiQuadCoefficients {
+		double b0{ };
+		double b1{ };
+		double b2{ };
+		double a1{ };
+		double a2{ };
+	};
+
+	// Filter that is represented as a chain of biquad sections.
+	// High order filters are much more numerically stable in this form than in the direct form.
+	struct SecondOrderSections {
+		std::vector<BiQuadCoefficients> sections;
+		double gainAmp = 1.0;
+
+		void addGainDbEnergy(double gainDB) {
+			gainAmp *= utils::MyMath::db2amplitude(gainDB * 0.5);
+		}
+
+		void append(const SecondOrderSections& other) {
+			sections.insert(sections.end(), other.sections.begin(), other.sections.end());
+			gainAmp *= other.gainAmp;
+		}
+	};
+}
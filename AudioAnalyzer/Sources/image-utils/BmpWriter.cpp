@@ -60,11 +60,14 @@ public:
 #pragma pack( pop )
 
 
-void utils::BmpWriter::writeFile(const string& filepath, array2d_view<IntColor> imageData) {
+bool utils::BmpWriter::writeFile(const string& filepath, array2d_view<IntColor> imageData) {
 	BMPHeader header(imageData.getBufferSize(), imageData.getBuffersCount());
 
 	FileWrapper file(filepath.c_str());
 
 	file.write(&header, sizeof(header));
 	file.write(imageData[0].data(), header.dibHeader.bitmapSizeInBytes);
+
+	// file is closed on any write error
+	return file.isValid();
 }
@@ -14,6 +14,7 @@
 namespace rxtd::utils {
 	class BmpWriter {
 	public:
-		static void writeFile(const string& filepath, array2d_view<IntColor> imageData);
+		// returns false if file couldn't be written
+		static bool writeFile(const string& filepath, array2d_view<IntColor> imageData);
 	};
 }
@@ -153,8 +153,8 @@ utils::Color utils::Color::hsl2hsv() const {
 utils::Color utils::Color::hsv2rgb() const {
 	const float chroma = _.hsv.val * _.hsv.sat;
 	float fractionalPart;
-	const float h = std::modff(_.hsv.hue * (1.0f / 60.0f) * (1.0f / 6.0f), &fractionalPart) * 6.0f;
-	const float hFraction = std::modff(h * 0.5f, &fractionalPart) * 2.0f;
+	const float h = std::modf(_.hsv.hue * (1.0f / 60.0f) * (1.0f / 6.0f), &fractionalPart) * 6.0f;
+	const float hFraction = std::modf(h * 0.5f, &fractionalPart) * 2.0f;
 	const float x = chroma * (1.0f - std::abs(hFraction - 1.0f));
 
 	struct {
@@ -55,7 +55,12 @@ namespace rxtd::utils {
 		}
 
 		[[nodiscard]]
-		static Color parse(sview desc, Color defaultValue = { });
+		static Color parse(sview desc) {
+			return parse(desc, { });
+		}
+
+		[[nodiscard]]
+		static Color parse(sview desc, Color defaultValue);
 
 		[[nodiscard]]
 		Color operator*(float value) const {
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "BmpWriter.h"
+#include "PngWriter.h"
+
+namespace rxtd::utils {
+	enum class ImageFormat {
+		BMP,
+		PNG,
+	};
+
+	class ImageFormatUtils {
+	public:
+		[[nodiscard]]
+		static sview getExtension(ImageFormat format) {
+			switch (format) {
+			case ImageFormat::BMP: return L".bmp";
+			case ImageFormat::PNG: return L".png";
+			}
+			return { };
+		}
+
+		// returns false if file couldn't be written
+		static bool writeFile(ImageFormat format, const string& filepath, array2d_view<IntColor> imageData) {
+			switch (format) {
+			case ImageFormat::BMP: return BmpWriter::writeFile(filepath, imageData);
+			case ImageFormat::PNG: return PngWriter::writeFile(filepath, imageData);
+			}
+			return false;
+		}
+	};
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "ImageWriteHelper.h"
+#include "windows-wrappers/FileWrapper.h"
+
+using namespace utils;
+
+void ImageWriteHelper::write(
+	array2d_view<IntColor> pixels, bool empty,
+	const string& filepath, ImageFormat format, ImageWriteQueue* queue
+) {
+	if (emptinessWritten && empty) {
+		return;
+	}
+
+	if (queue != nullptr) {
+		queue->push(filepath, pixels, format);
+	} else {
+		FileWrapper::createDirectories(filepath);
+		ImageFormatUtils::writeFile(format, filepath, pixels);
+	}
+
+	emptinessWritten = empty;
+}
+
+bool ImageWriteHelper::getQueueProp(isview prop, sview filepath, ImageWriteQueue* queue, BufferPrinter& printer) {
+	index ImageWriteQueue::Stats::* field;
+	if (prop == L"frames written") {
+		field = &ImageWriteQueue::Stats::written;
+	} else if (prop == L"frames coalesced") {
+		field = &ImageWriteQueue::Stats::coalesced;
+	} else if (prop == L"frames dropped") {
+		field = &ImageWriteQueue::Stats::dropped;
+	} else {
+		return false;
+	}
+
+	// images that are written directly don't have any statistics
+	const auto stats = queue == nullptr ? ImageWriteQueue::Stats{ } : queue->getStats(filepath);
+	printer.print(stats.*field);
+	return true;
+}
@@ -9,28 +9,29 @@
 
 #pragma once
 #include "BmpWriter.h"
-#include "windows-wrappers/FileWrapper.h"
+#include "BufferPrinter.h"
+#include "ImageFormat.h"
+#include "ImageWriteQueue.h"
 
 namespace rxtd::utils {
+	// Rewrites the whole image file on each write, or hands the image over to the queue when it is provided.
+	// Image that stays empty is only written once.
 	class ImageWriteHelper {
 		bool emptinessWritten = false;
 
 	public:
-		void write(array2d_view<IntColor> pixels, bool empty, const string& filepath) {
-			if (emptinessWritten && empty) {
-				return;
-			}
-
-			FileWrapper::createDirectories(filepath);
-
-			BmpWriter::writeFile(filepath, pixels);
-
-			emptinessWritten = empty;
-		}
+		void write(
+			array2d_view<IntColor> pixels, bool empty,
+			const string& filepath, ImageFormat format, ImageWriteQueue* queue
+		);
 
 		[[nodiscard]]
 		bool isEmptinessWritten() const {
 			return emptinessWritten;
 		}
+
+		// handles props "frames written", "frames coalesced" and "frames dropped"
+		// returns false if prop is not one of them
+		static bool getQueueProp(isview prop, sview filepath, ImageWriteQueue* queue, BufferPrinter& printer);
 	};
 }
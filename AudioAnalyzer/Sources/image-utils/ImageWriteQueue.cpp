@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "ImageWriteQueue.h"
+#include "windows-wrappers/FileWrapper.h"
+
+using namespace utils;
+
+void ImageWriteQueue::push(const string& filepath, array2d_view<IntColor> pixels, ImageFormat format) {
+	std::unique_lock<std::mutex> lock{ mutex };
+
+	if (!thread.joinable()) {
+		// most of the measures don't have images, so thread is only created when it's needed
+		thread = std::thread{ [this]() { threadFunction(); } };
+	}
+
+	auto [iter, inserted] = pending.try_emplace(filepath);
+	if (!inserted) {
+		stats[filepath].coalesced++;
+	}
+	iter->second.pixels.copyWithResize(pixels);
+	iter->second.format = format;
+
+	lock.unlock();
+	wakeVariable.notify_one();
+}
+
+ImageWriteQueue::Stats ImageWriteQueue::getStats(sview filepath) {
+	std::lock_guard<std::mutex> lock{ mutex };
+
+	const auto iter = stats.find(filepath);
+	if (iter == stats.end()) {
+		return { };
+	}
+	return iter->second;
+}
+
+void ImageWriteQueue::stop() {
+	if (!thread.joinable()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		stopRequest = true;
+	}
+	wakeVariable.notify_one();
+
+	thread.join();
+}
+
+void ImageWriteQueue::threadFunction() {
+	std::unique_lock<std::mutex> lock{ mutex };
+	string lastPath;
+
+	while (true) {
+		wakeVariable.wait(lock, [&] { return stopRequest || !pending.empty(); });
+		if (pending.empty()) {
+			// frames that were pushed before the stop request are still written
+			return;
+		}
+
+		// files are taken in turn, so that a frequently updated file doesn't block the others
+		auto iter = pending.upper_bound(lastPath);
+		if (iter == pending.end()) {
+			iter = pending.begin();
+		}
+
+		// node is removed from the map, so that new frames of the same file don't touch it while it's being written
+		auto node = pending.extract(iter);
+		lastPath = node.key();
+
+		lock.unlock();
+		const bool success = writeFile(node.key(), node.mapped());
+		lock.lock();
+
+		auto& fileStats = stats[node.key()];
+		if (success) {
+			fileStats.written++;
+		} else {
+			fileStats.dropped++;
+		}
+	}
+}
+
+bool ImageWriteQueue::writeFile(const string& filepath, const Frame& frame) {
+	FileWrapper::createDirectories(filepath);
+
+	const string tempPath = filepath + L".tmp";
+	if (!ImageFormatUtils::writeFile(frame.format, tempPath, frame.pixels)) {
+		return false;
+	}
+
+	return FileWrapper::replaceFile(tempPath, filepath);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "ImageFormat.h"
+#include "IntColor.h"
+#include "Vector2D.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace rxtd::utils {
+	// Writes images in a separate thread, so that slow disk doesn't block the caller.
+	//
+	// When several frames of the same file are waiting, only the latest one is kept.
+	// Each frame is written into a temporary file that then replaces the target file,
+	// so that readers never see partially written image.
+	class ImageWriteQueue : NonMovableBase {
+	public:
+		struct Stats {
+			index written = 0;
+			// frames that were replaced by a newer frame of the same file before they were written
+			index coalesced = 0;
+			// frames that couldn't be written because of file system errors
+			index dropped = 0;
+		};
+
+	private:
+		struct Frame {
+			Vector2D<IntColor> pixels;
+			ImageFormat format{ };
+		};
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable wakeVariable;
+		bool stopRequest = false;
+
+		// file path → latest frame
+		std::map<string, Frame, std::less<>> pending;
+		std::map<string, Stats, std::less<>> stats;
+
+	public:
+		ImageWriteQueue() = default;
+
+		// pending frames are written before the object is destroyed
+		~ImageWriteQueue() {
+			stop();
+		}
+
+		// copies pixels, so the caller can reuse its buffer right away
+		void push(const string& filepath, array2d_view<IntColor> pixels, ImageFormat format);
+
+		[[nodiscard]]
+		Stats getStats(sview filepath);
+
+	private:
+		void stop();
+		void threadFunction();
+		static bool writeFile(const string& filepath, const Frame& frame);
+	};
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "PngWriter.h"
+#include "windows-wrappers/FileWrapper.h"
+#include <array>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace rxtd::utils {
+	namespace {
+		constexpr std::array<uint32_t, 256> makeCrcTable() {
+			std::array<uint32_t, 256> result{ };
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t value = i;
+				for (index bit = 0; bit < 8; bit++) {
+					value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				}
+				result[i] = value;
+			}
+			return result;
+		}
+
+		constexpr auto crcTable = makeCrcTable();
+
+		uint32_t calculateCrc(const std::byte* data, index size) {
+			uint32_t crc = 0xFFFFFFFFu;
+			for (index i = 0; i < size; i++) {
+				crc = crcTable[(crc ^ uint32_t(data[i])) & 0xFF] ^ (crc >> 8);
+			}
+			return crc ^ 0xFFFFFFFFu;
+		}
+
+		class Adler32 {
+			// largest count of bytes that can't overflow 32-bit sums, rounded down to the size of SIMD vector
+			static constexpr index maxBlockSize = 5552 / 16 * 16;
+			static constexpr uint32_t modulo = 65521;
+
+			uint32_t a = 1;
+			uint32_t b = 0;
+
+		public:
+			void update(const std::byte* data, index size) {
+				while (size > 0) {
+					const index blockSize = std::min(size, maxBlockSize);
+					const index vectorSize = blockSize / 16 * 16;
+
+					updateVector(data, vectorSize);
+					for (index i = vectorSize; i < blockSize; i++) {
+						a += uint32_t(data[i]);
+						b += a;
+					}
+					a %= modulo;
+					b %= modulo;
+
+					data += blockSize;
+					size -= blockSize;
+				}
+			}
+
+			[[nodiscard]]
+			uint32_t get() const {
+				return (b << 16) | a;
+			}
+
+		private:
+			// b grows by a for each byte, and each byte is added to b once for each byte after it,
+			// so sums can be computed for 16 bytes at once instead of one byte after another
+			void updateVector(const std::byte* data, index size) {
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i weightsHigh = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+				const __m128i weightsLow = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+
+				__m128i sum = zero;
+				__m128i previousSums = zero;
+				__m128i weightedSum = zero;
+
+				for (index i = 0; i < size; i += 16) {
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+					previousSums = _mm_add_epi32(previousSums, sum);
+					sum = _mm_add_epi32(sum, _mm_sad_epu8(bytes, zero));
+
+					weightedSum = _mm_add_epi32(weightedSum, _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weightsHigh));
+					weightedSum = _mm_add_epi32(weightedSum, _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weightsLow));
+				}
+
+				const auto horizontalSum = [](__m128i value) {
+					value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+					value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+					return uint32_t(_mm_cvtsi128_si32(value));
+				};
+
+				b += uint32_t(size) * a + 16 * horizontalSum(previousSums) + horizontalSum(weightedSum);
+				a += horizontalSum(sum);
+			}
+		};
+
+		void writeBigEndian(std::vector<std::byte>& dest, uint32_t value) {
+			dest.push_back(std::byte(value >> 24));
+			dest.push_back(std::byte(value >> 16));
+			dest.push_back(std::byte(value >> 8));
+			dest.push_back(std::byte(value));
+		}
+
+		void writeChunk(std::vector<std::byte>& dest, const char (&type)[5], const std::vector<std::byte>& data) {
+			writeBigEndian(dest, uint32_t(data.size()));
+
+			const index crcBegin = dest.size();
+			for (index i = 0; i < 4; i++) {
+				dest.push_back(std::byte(type[i]));
+			}
+			dest.insert(dest.end(), data.begin(), data.end());
+
+			writeBigEndian(dest, calculateCrc(dest.data() + crcBegin, index(dest.size()) - crcBegin));
+		}
+
+		// writes into memory that is allocated in advance
+		class BitWriter {
+			std::byte* dest;
+			uint64_t buffer = 0;
+			index bitsCount = 0;
+
+		public:
+			explicit BitWriter(std::byte* dest) : dest(dest) { }
+
+			// deflate packs values starting from the least significant bit
+			void write(uint32_t value, index count) {
+				buffer |= uint64_t(value) << bitsCount;
+				bitsCount += count;
+				if (bitsCount >= 32) {
+					for (index i = 0; i < 4; i++) {
+						dest[i] = std::byte(buffer >> (i * 8));
+					}
+					dest += 4;
+					buffer >>= 32;
+					bitsCount -= 32;
+				}
+			}
+
+			// returns pointer past the last written byte
+			std::byte* flush() {
+				while (bitsCount > 0) {
+					*dest = std::byte(buffer & 0xFF);
+					dest++;
+					buffer >>= 8;
+					bitsCount -= 8;
+				}
+				buffer = 0;
+				bitsCount = 0;
+				return dest;
+			}
+		};
+
+		struct HuffmanCode {
+			uint16_t bits;
+			uint8_t length;
+		};
+
+		// Huffman codes are packed starting from the most significant bit,
+		// so they are stored already reversed
+		constexpr HuffmanCode makeReversedCode(uint32_t code, uint8_t length) {
+			uint32_t reversed = 0;
+			for (index i = 0; i < length; i++) {
+				reversed = (reversed << 1) | (code & 1);
+				code >>= 1;
+			}
+			return { uint16_t(reversed), length };
+		}
+
+		// fixed Huffman codes from RFC 1951, section 3.2.6
+		constexpr std::array<HuffmanCode, 288> makeLiteralCodes() {
+			std::array<HuffmanCode, 288> result{ };
+			for (uint32_t value = 0; value < 288; value++) {
+				if (value < 144) {
+					result[value] = makeReversedCode(0x30 + value, 8);
+				} else if (value < 256) {
+					result[value] = makeReversedCode(0x190 + value - 144, 9);
+				} else if (value < 280) {
+					result[value] = makeReversedCode(value - 256, 7);
+				} else {
+					result[value] = makeReversedCode(0xC0 + value - 280, 8);
+				}
+			}
+			return result;
+		}
+
+		constexpr auto literalCodes = makeLiteralCodes();
+
+		void writeLiteral(BitWriter& writer, index value) {
+			const auto code = literalCodes[value];
+			writer.write(code.bits, code.length);
+		}
+
+		constexpr index minMatchLength = 3;
+		constexpr index maxMatchLength = 258;
+		constexpr index pixelSize = 4;
+		// longest match that consists of whole pixels
+		constexpr index maxMatchPixels = maxMatchLength / pixelSize;
+
+		void writeRepeat(BitWriter& writer, index length, index distanceCode) {
+			constexpr std::array<uint16_t, 28> lengthBase{
+				3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+				35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227,
+			};
+			constexpr std::array<uint8_t, 28> lengthExtraBits{
+				0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+				3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5,
+			};
+
+			if (length == maxMatchLength) {
+				writeLiteral(writer, 285);
+			} else {
+				index code = index(lengthBase.size()) - 1;
+				while (lengthBase[code] > length) {
+					code--;
+				}
+				writeLiteral(writer, 257 + code);
+				writer.write(uint32_t(length - lengthBase[code]), lengthExtraBits[code]);
+			}
+
+			// distances 1 to 4 have codes 0 to 3 without extra bits
+			writer.write(makeReversedCode(uint32_t(distanceCode), 5).bits, 5);
+		}
+
+		// Only finds repeats of the previous pixel, which is the most common case in generated images,
+		// and is much faster than general search.
+		void deflateRow(BitWriter& writer, array_view<IntColor> source, const std::byte* rgba) {
+			// filter type: none
+			writeLiteral(writer, 0);
+
+			const index width = source.size();
+			index x = 0;
+			while (x < width) {
+				if (x > 0) {
+					const uint32_t previous = source[x - 1].full;
+					index runLength = 0;
+					while (x + runLength < width && source[x + runLength].full == previous) {
+						runLength++;
+					}
+
+					if (runLength > 0) {
+						x += runLength;
+						while (runLength > 0) {
+							const index matchPixels = std::min(runLength, maxMatchPixels);
+							// distance of 4 bytes is code 3
+							writeRepeat(writer, matchPixels * pixelSize, 3);
+							runLength -= matchPixels;
+						}
+						continue;
+					}
+				}
+
+				for (index i = 0; i < pixelSize; i++) {
+					writeLiteral(writer, index(rgba[x * pixelSize + i]));
+				}
+				x++;
+			}
+		}
+	}
+
+	bool PngWriter::writeFile(const string& filepath, array2d_view<IntColor> imageData) {
+		std::vector<std::byte> buffer;
+		encode(imageData, buffer);
+
+		FileWrapper file(filepath.c_str());
+		file.write(buffer.data(), buffer.size());
+
+		// file is closed on any write error
+		return file.isValid();
+	}
+
+	void PngWriter::encode(array2d_view<IntColor> imageData, std::vector<std::byte>& dest) {
+		const index width = imageData.getBufferSize();
+		const index height = imageData.getBuffersCount();
+
+		dest.clear();
+		constexpr std::array<uint8_t, 8> signature{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		for (auto value : signature) {
+			dest.push_back(std::byte(value));
+		}
+
+		std::vector<std::byte> chunkData;
+		writeBigEndian(chunkData, uint32_t(width));
+		writeBigEndian(chunkData, uint32_t(height));
+		chunkData.push_back(std::byte(8)); // bits per channel
+		chunkData.push_back(std::byte(6)); // RGBA
+		chunkData.push_back(std::byte(0)); // deflate
+		chunkData.push_back(std::byte(0)); // adaptive filtering
+		chunkData.push_back(std::byte(0)); // no interlace
+		writeChunk(dest, "IHDR", chunkData);
+
+		const index rowSize = 1 + width * pixelSize;
+
+		chunkData.clear();
+		// zlib header: deflate with 32K window, fastest compression
+		chunkData.push_back(std::byte(0x78));
+		chunkData.push_back(std::byte(0x01));
+
+		// literals are at most 9 bits long, so incompressible data grows by at most 1/8
+		const index deflateBegin = chunkData.size();
+		chunkData.resize(deflateBegin + height * rowSize * 9 / 8 + 16);
+		BitWriter writer{ chunkData.data() + deflateBegin };
+
+		// single final block with fixed Huffman codes
+		writer.write(1, 1);
+		writer.write(1, 2);
+
+		Adler32 adler;
+		std::vector<std::byte> row;
+		row.resize(rowSize);
+
+		// PNG rows go from top to bottom
+		for (index rowIndex = height - 1; rowIndex >= 0; rowIndex--) {
+			const auto source = imageData[rowIndex];
+
+			row[0] = std::byte(0);
+			std::byte* rgba = row.data() + 1;
+			for (index x = 0; x < width; x++) {
+				// BGRA → RGBA
+				const uint32_t value = source[x].full;
+				const uint32_t swapped = (value & 0xFF00FF00u) | ((value >> 16) & 0xFFu) | ((value & 0xFFu) << 16);
+				std::memcpy(rgba + x * pixelSize, &swapped, sizeof(swapped));
+			}
+			adler.update(row.data(), rowSize);
+
+			deflateRow(writer, source, rgba);
+		}
+
+		writeLiteral(writer, 256); // end of block
+		const std::byte* deflateEnd = writer.flush();
+		chunkData.resize(deflateEnd - chunkData.data());
+
+		writeBigEndian(chunkData, adler.get());
+		writeChunk(dest, "IDAT", chunkData);
+
+		chunkData.clear();
+		writeChunk(dest, "IEND", chunkData);
+	}
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "Vector2D.h"
+#include "IntColor.h"
+
+namespace rxtd::utils {
+	// Writes 32-bit RGBA PNG files.
+	//
+	// Encoder is tuned for speed rather than for size:
+	// deflate only searches for runs of the same pixel and uses fixed Huffman codes.
+	// Images with large areas of solid background, like spectrograms and waveforms, compress very well this way.
+	class PngWriter {
+	public:
+		// returns false if file couldn't be written
+		static bool writeFile(const string& filepath, array2d_view<IntColor> imageData);
+
+		// Rows of imageData are stored bottom-up, same as in BMP files.
+		static void encode(array2d_view<IntColor> imageData, std::vector<std::byte>& dest);
+	};
+}
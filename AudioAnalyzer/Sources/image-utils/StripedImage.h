@@ -12,11 +12,18 @@
 #include "GrowingVector.h"
 
 namespace rxtd::utils {
+	// Image that is filled by vertical strips.
+	//
+	// Strips are stored contiguously in a ring buffer,
+	// so pushing a strip is one sequential write and scrolling the image is just an index increment.
+	// Row-major image is assembled from the strips only when it is requested,
+	// and only strips that were pushed since the last request are copied into it.
 	template <typename PIXEL_VALUE_TYPE>
 	class StripedImage {
 		using PixelValueType = PIXEL_VALUE_TYPE;
 
-		GrowingVector<PixelValueType> pixelData{ };
+		// strip i occupies [i * height, (i + 1) * height)
+		std::vector<PixelValueType> stripsData{ };
 		index width = 0;
 		index height = 0;
 
@@ -24,7 +31,16 @@ namespace rxtd::utils {
 		PixelValueType lastFillValue = { };
 		index sameStripsCount = 0;
 		bool stationary = false;
-		index stationaryOffset = 0;
+		// position in the ring of the strip that will be written next
+		// in stationary mode strip positions are the same as image columns
+		index nextStripIndex = 0;
+
+		// row-major image
+		// when image is not stationary, each row is shifted by one pixel for each new strip
+		// by moving the beginning of the data, so that the newest strips are always at the end of rows
+		mutable GrowingVector<PixelValueType> pixelData{ };
+		// strips that were pushed since #pixelData was assembled
+		mutable index pendingStripsCount = 0;
 
 	public:
 		void setParams(index _width, index _height, PixelValueType _backgroundValue, bool _stationary) {
@@ -41,11 +57,14 @@ namespace rxtd::utils {
 			width = _width;
 			height = _height;
 
-			const index imagePixelsCount = _width * _height;
-			const index maxOffset = getReserveSize(imagePixelsCount);
+			stripsData.clear();
+			stripsData.resize(width * height, backgroundValue);
+			nextStripIndex = 0;
 
+			const index imagePixelsCount = _width * _height;
 			pixelData.reset(imagePixelsCount, backgroundValue);
-			pixelData.setMaxSize(imagePixelsCount + maxOffset);
+			pixelData.setMaxSize(imagePixelsCount + getReserveSize(imagePixelsCount));
+			pendingStripsCount = 0;
 
 			lastFillValue = backgroundValue;
 			sameStripsCount = _width - 1;
@@ -54,28 +73,25 @@ namespace rxtd::utils {
 		void pushStrip(array_view<PixelValueType> stripData) {
 			sameStripsCount = 0;
 
-			index nextStripIndex = incrementAndGetIndex();
-			auto imageLines = getCurrentLinesArray(); // must be after #incrementAndGetIndex
-			for (index i = 0; i < stripData.size(); i++) {
-				imageLines[i][nextStripIndex] = stripData[i];
-			}
+			std::copy_n(stripData.data(), stripData.size(), getNextStrip());
+			incrementStrip();
 		}
 
-		void pushEmptyStrip(PixelValueType value) {
+		// returns false if image is already filled with the value, and strip wasn't added
+		bool pushEmptyStrip(PixelValueType value) {
 			if (lastFillValue != value || sameStripsCount == 0) {
 				lastFillValue = value;
 				sameStripsCount = 1;
 			} else if (isEmpty()) {
-				return;
+				return false;
 			} else {
 				sameStripsCount++;
 			}
 
-			index nextStripIndex = incrementAndGetIndex();
-			auto imageLines = getCurrentLinesArray(); // must be after #incrementAndGetIndex
-			for (index i = 0; i < height; i++) {
-				imageLines[i][nextStripIndex] = value;
-			}
+			std::fill_n(getNextStrip(), height, value);
+			incrementStrip();
+
+			return true;
 		}
 
 		[[nodiscard]]
@@ -84,7 +100,7 @@ namespace rxtd::utils {
 			if (!stationary) {
 				return bufferIsEmpty;
 			} else {
-				index lastStripIndex = stationaryOffset - 1;
+				index lastStripIndex = nextStripIndex - 1;
 				if (lastStripIndex < 0) {
 					lastStripIndex += width;
 				}
@@ -95,11 +111,14 @@ namespace rxtd::utils {
 
 		[[nodiscard]]
 		array2d_view<PixelValueType> getPixels() const {
-			return getCurrentLinesArray();
+			updatePixels();
+			return { pixelData.getPointer(), height, width };
 		}
 
+		// Changes in the returned buffer are kept until the next strip is pushed into the changed column.
 		[[nodiscard]]
 		array2d_span<PixelValueType> getPixelsWritable() {
+			updatePixels();
 			return getCurrentLinesArray();
 		}
 
@@ -109,20 +128,22 @@ namespace rxtd::utils {
 				return 0;
 			}
 
-			return stationaryOffset;
+			return nextStripIndex;
 		}
 
 	private:
-		// returns index of next string to write to
-		index incrementAndGetIndex() {
-			if (stationary) {
-				const index resultIndex = stationaryOffset;
-				incrementStationary();
-				return resultIndex;
+		[[nodiscard]]
+		PixelValueType* getNextStrip() {
+			return stripsData.data() + nextStripIndex * height;
+		}
+
+		void incrementStrip() {
+			nextStripIndex++;
+			if (nextStripIndex >= width) {
+				nextStripIndex = 0;
 			}
 
-			incrementStrip();
-			return width - 1;
+			pendingStripsCount = std::min(pendingStripsCount + 1, width);
 		}
 
 		[[nodiscard]]
@@ -136,25 +157,70 @@ namespace rxtd::utils {
 		}
 
 		[[nodiscard]]
-		array2d_span<PixelValueType> getCurrentLinesArray() {
+		array2d_span<PixelValueType> getCurrentLinesArray() const {
 			return { pixelData.getPointer(), height, width };
 		}
 
-		[[nodiscard]]
-		array2d_view<PixelValueType> getCurrentLinesArray() const {
-			return { pixelData.getPointer(), height, width };
-		}
+		void updatePixels() const {
+			if (pendingStripsCount == 0) {
+				return;
+			}
 
-		void incrementStrip() {
-			pixelData.removeFirst(1);
-			(void)pixelData.allocateNext(1);
+			if (pendingStripsCount >= width) {
+				if (stationary) {
+					copyStrips(0, width, 0);
+				} else {
+					// oldest strip is the first column of the image
+					copyStrips(nextStripIndex, width - nextStripIndex, 0);
+					copyStrips(0, nextStripIndex, width - nextStripIndex);
+				}
+
+				pendingStripsCount = 0;
+				return;
+			}
+
+			index firstStrip = nextStripIndex - pendingStripsCount;
+			if (firstStrip < 0) {
+				firstStrip += width;
+			}
+			const index firstPartCount = std::min(pendingStripsCount, width - firstStrip);
+
+			if (stationary) {
+				copyStrips(firstStrip, firstPartCount, firstStrip);
+				copyStrips(0, pendingStripsCount - firstPartCount, 0);
+			} else {
+				pixelData.removeFirst(pendingStripsCount);
+				(void)pixelData.allocateNext(pendingStripsCount);
+
+				const index firstColumn = width - pendingStripsCount;
+				copyStrips(firstStrip, firstPartCount, firstColumn);
+				copyStrips(0, pendingStripsCount - firstPartCount, firstColumn + firstPartCount);
+			}
+
+			pendingStripsCount = 0;
 		}
 
-		void incrementStationary() {
-			stationaryOffset++;
+		// transposes count strips starting from firstStrip into columns starting from firstColumn
+		void copyStrips(index firstStrip, index count, index firstColumn) const {
+			auto pixels = getCurrentLinesArray();
 
-			if (stationaryOffset >= width) {
-				stationaryOffset = 0;
+			// copying is done in square blocks, so that both source and destination stay in cache
+			constexpr index blockSize = 16;
+
+			for (index rowBegin = 0; rowBegin < height; rowBegin += blockSize) {
+				const index rowEnd = std::min(rowBegin + blockSize, height);
+
+				for (index stripBegin = 0; stripBegin < count; stripBegin += blockSize) {
+					const index stripEnd = std::min(stripBegin + blockSize, count);
+
+					for (index row = rowBegin; row < rowEnd; row++) {
+						auto dest = pixels[row];
+						const PixelValueType* source = stripsData.data() + firstStrip * height + row;
+						for (index strip = stripBegin; strip < stripEnd; strip++) {
+							dest[firstColumn + strip] = source[strip * height];
+						}
+					}
+				}
 			}
 		}
 	};
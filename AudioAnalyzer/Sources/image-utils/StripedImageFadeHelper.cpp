@@ -8,22 +8,43 @@
  */
 
 #include "StripedImageFadeHelper.h"
-#include "IntMixer.h"
 
 using namespace utils;
 
 void StripedImageFadeHelper::inflate(array2d_view<IntColor> source) {
+	const index width = source.getBufferSize();
 	const index height = source.getBuffersCount();
 
-	resultBuffer.setBufferSize(source.getBufferSize());
-	resultBuffer.setBuffersCount(source.getBuffersCount());
+	if (resultBuffer.getBufferSize() != width || resultBuffer.getBuffersCount() != height) {
+		resultBuffer.setBufferSize(width);
+		resultBuffer.setBuffersCount(height);
+		fullRedrawNeeded = true;
+	}
 
-	for (index lineIndex = 0; lineIndex < height; ++lineIndex) {
-		auto sourceLine = source[lineIndex];
-		auto destLine = resultBuffer[lineIndex];
+	if (fullRedrawNeeded) {
+		updateFadeMixers(width);
+	}
 
-		inflateLine(sourceLine, destLine);
+	const index fadeWidth = index(fadeMixers.size());
+
+	// When image is not stationary, all strips move on each update.
+	// Otherwise only new strips and strips that are or were in the fading and border area need to be redrawn.
+	index from = 0;
+	index count = width;
+	if (stationary && !fullRedrawNeeded && newStripsCount + borderSize + fadeWidth < width) {
+		count = newStripsCount + borderSize + fadeWidth;
+		from = pastLastStripIndex - newStripsCount;
+		if (from < 0) {
+			from += width;
+		}
 	}
+
+	for (index lineIndex = 0; lineIndex < height; ++lineIndex) {
+		inflateLine(source[lineIndex], resultBuffer[lineIndex], from, count);
+	}
+
+	newStripsCount = 0;
+	fullRedrawNeeded = false;
 }
 
 void StripedImageFadeHelper::drawBorderInPlace(array2d_span<IntColor> source) const {
@@ -34,80 +55,67 @@ void StripedImageFadeHelper::drawBorderInPlace(array2d_span<IntColor> source) co
 	}
 }
 
-void StripedImageFadeHelper::inflateLine(array_view<IntColor> source, array_span<IntColor> dest) const {
-	const index width = source.size();
-
+void StripedImageFadeHelper::updateFadeMixers(index width) {
 	const index realWidth = width - borderSize;
-
 	const index fadeWidth = index(realWidth * fading);
-	const index flatWidth = realWidth - fadeWidth;
-
-	IntMixer<> mixer;
-	const auto back = background;
 
 	const double fadeDistanceStep = 1.0 / (realWidth * fading);
 	double fadeDistance = 1.0;
 
-	index fadeBeginIndex = pastLastStripIndex + borderSize;
-	if (fadeBeginIndex >= width) {
-		fadeBeginIndex -= width;
-	}
-
-	index flatBeginIndex = fadeBeginIndex + fadeWidth;
-
-	if (flatBeginIndex >= width) {
-		for (index i = fadeBeginIndex; i < width; i++) {
-			mixer.setFactor(fadeDistance * fadeDistance);
-			auto sc = source[i];
-			sc.a = mixer.mix(back.a, sc.a);
-			sc.r = mixer.mix(back.r, sc.r);
-			sc.g = mixer.mix(back.g, sc.g);
-			sc.b = mixer.mix(back.b, sc.b);
-			dest[i] = sc;
-
-			fadeDistance -= fadeDistanceStep;
-		}
-
-		fadeBeginIndex = 0;
-		flatBeginIndex -= width;
-	}
-
-	for (index i = fadeBeginIndex; i < flatBeginIndex; i++) {
+	fadeMixers.resize(fadeWidth);
+	for (auto& mixer : fadeMixers) {
 		mixer.setFactor(fadeDistance * fadeDistance);
-		auto sc = source[i];
-		sc.a = mixer.mix(back.a, sc.a);
-		sc.r = mixer.mix(back.r, sc.r);
-		sc.g = mixer.mix(back.g, sc.g);
-		sc.b = mixer.mix(back.b, sc.b);
-		dest[i] = sc;
-
 		fadeDistance -= fadeDistanceStep;
 	}
+}
 
-	index borderBeginIndex = flatBeginIndex + flatWidth;
-	if (borderBeginIndex >= width) {
-		for (index i = flatBeginIndex; i < width; i++) {
-			dest[i] = source[i];
-		}
+void StripedImageFadeHelper::inflateLine(
+	array_view<IntColor> source, array_span<IntColor> dest,
+	index from, index count
+) const {
+	const index width = source.size();
+	const index fadeEnd = borderSize + index(fadeMixers.size());
+	const auto back = background;
 
-		flatBeginIndex = 0;
-		borderBeginIndex -= width;
+	// distance from the border, which is drawn right after the last strip
+	index distance = from - pastLastStripIndex;
+	if (distance < 0) {
+		distance += width;
 	}
 
-	for (index i = flatBeginIndex; i < borderBeginIndex; i++) {
-		dest[i] = source[i];
-	}
+	index column = from;
+	while (count > 0) {
+		index runLength = std::min(count, width - column);
+
+		if (distance < borderSize) {
+			runLength = std::min(runLength, borderSize - distance);
+			std::fill_n(dest.data() + column, runLength, border);
+		} else if (distance < fadeEnd) {
+			runLength = std::min(runLength, fadeEnd - distance);
+			const auto mixers = fadeMixers.data() + (distance - borderSize);
+			for (index i = 0; i < runLength; i++) {
+				const auto& mixer = mixers[i];
+				auto sc = source[column + i];
+				sc.a = mixer.mix(back.a, sc.a);
+				sc.r = mixer.mix(back.r, sc.r);
+				sc.g = mixer.mix(back.g, sc.g);
+				sc.b = mixer.mix(back.b, sc.b);
+				dest[column + i] = sc;
+			}
+		} else {
+			runLength = std::min(runLength, width - distance);
+			std::copy_n(source.data() + column, runLength, dest.data() + column);
+		}
 
-	index borderEndIndex = borderBeginIndex + borderSize;
-	if (borderEndIndex >= width) {
-		for (index i = borderBeginIndex; i < width; i++) {
-			dest[i] = border;
+		column += runLength;
+		if (column >= width) {
+			column -= width;
 		}
-		borderBeginIndex = 0;
-		borderEndIndex -= width;
-	}
-	for (index i = borderBeginIndex; i < borderEndIndex; i++) {
-		dest[i] = border;
+		distance += runLength;
+		if (distance >= width) {
+			distance -= width;
+		}
+		count -= runLength;
 	}
 }
 
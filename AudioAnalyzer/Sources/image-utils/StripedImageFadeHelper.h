@@ -10,6 +10,7 @@
 #pragma once
 #include "StripedImage.h"
 #include "Color.h"
+#include "IntMixer.h"
 
 namespace rxtd::utils {
 	class StripedImageFadeHelper {
@@ -18,37 +19,57 @@ namespace rxtd::utils {
 		index borderSize = 0;
 		index pastLastStripIndex{ };
 		double fading = 0.0;
+		bool stationary = false;
 
 		IntColor background{ };
 		IntColor border{ };
 
+		// mixer for each column of the fading area, starting from the border
+		std::vector<IntMixer<>> fadeMixers;
+
+		// strips that were added to the source image since last #inflate call
+		index newStripsCount = 0;
+		bool fullRedrawNeeded = true;
+
 	public:
 		void setParams(
 			IntColor _background,
 			index _borderSize, IntColor _border,
-			double _fading
+			double _fading, bool _stationary
 		) {
 			background = _background;
 			borderSize = _borderSize;
 			border = _border;
 			fading = _fading;
+			stationary = _stationary;
+
+			fullRedrawNeeded = true;
 		}
 
 		void setPastLastStripIndex(index value) {
 			pastLastStripIndex = value;
 		}
 
+		void addStrips(index count) {
+			newStripsCount += count;
+		}
+
 		[[nodiscard]]
 		array2d_view<IntColor> getResultBuffer() const {
 			return resultBuffer;
 		}
 
+		// When source image is stationary, only changed strips and the area of fading and border are redrawn.
+		// Strips must be reported with #addStrips.
 		void inflate(array2d_view<IntColor> source);
 
 		void drawBorderInPlace(array2d_span<IntColor> source) const;
 
 	private:
-		void inflateLine(array_view<IntColor> source, array_span<IntColor> dest) const;
+		void updateFadeMixers(index width);
+
+		// draws count columns starting from the column #from, wrapping around the end of the image
+		void inflateLine(array_view<IntColor> source, array_span<IntColor> dest, index from, index count) const;
 
 		void drawBorderInLine(array_span<IntColor> line) const;
 	};
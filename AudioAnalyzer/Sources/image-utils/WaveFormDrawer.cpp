@@ -22,20 +22,28 @@ void WaveFormDrawer::setImageParams(index width, index height, bool stationary)
 	const index centerLineIndex = interpolator.toValueD(0.0);
 
 	minMaxBuffer.setParams(width, 1, { centerLineIndex, centerLineIndex }, stationary);
+	waveBuffer.setParams(width, height, { }, stationary);
+	stripBuffer.resize(height);
 	resultBuffer.setBufferSize(width);
 	resultBuffer.setBuffersCount(height);
 
 	this->width = width;
 	this->height = height;
+	this->stationary = stationary;
 
 	prev.minPixel = centerLineIndex;
 	prev.maxPixel = centerLineIndex;
+
+	updateLineBackgrounds();
+	fullRedrawNeeded = true;
 }
 
 void WaveFormDrawer::fillSilence() {
 	const index centerLineIndex = interpolator.toValueD(0.0);
 	const MinMax mm{ centerLineIndex, centerLineIndex };
-	minMaxBuffer.pushEmptyStrip(mm);
+	if (minMaxBuffer.pushEmptyStrip(mm)) {
+		pushWaveStrip(mm);
+	}
 }
 
 void WaveFormDrawer::fillStrip(double min, double max) {
@@ -57,110 +65,151 @@ void WaveFormDrawer::fillStrip(double min, double max) {
 
 	MinMax mm{ minPixel, maxPixel };
 	minMaxBuffer.pushStrip({ &mm, 1 });
+	pushWaveStrip(mm);
 }
 
 void WaveFormDrawer::inflate() {
-	const index centerLineIndex = interpolator.toValueD(0.0);
-	const index lowLineBound = centerLineIndex - (lineThickness - 1) / 2;
-	const index highLineBound = centerLineIndex + (lineThickness) / 2;
-
-	for (index lineIndex = 0; lineIndex < lowLineBound; ++lineIndex) {
-		inflateLine(lineIndex, resultBuffer[lineIndex], colors.background);
+	if (fullRedrawNeeded) {
+		redrawWaveBuffer();
 	}
 
-	for (index i = lowLineBound; i <= highLineBound; ++i) {
-		switch (lineDrawingPolicy) {
-		case LineDrawingPolicy::eNEVER: {
-			inflateLine(i, resultBuffer[i], colors.background);
-			break;
-		}
-		case LineDrawingPolicy::eBELOW_WAVE: {
-			inflateLine(i, resultBuffer[i], colors.line);
-			break;
-		}
-		case LineDrawingPolicy::eALWAYS: {
-			std::fill_n(resultBuffer[i].data(), resultBuffer.getBufferSize(), colors.line);
-			break;
-		}
+	const index realWidth = width - borderSize;
+	const index fadeWidth = index(realWidth * fading);
+
+	// When image is not stationary, all strips move on each update.
+	// Otherwise only new strips and strips that are or were in the fading and border area need to be redrawn.
+	index from = 0;
+	index count = width;
+	if (stationary && !fullRedrawNeeded && newStripsCount + borderSize + fadeWidth < width) {
+		count = newStripsCount + borderSize + fadeWidth;
+		from = minMaxBuffer.getPastLastStripIndex() - newStripsCount;
+		if (from < 0) {
+			from += width;
 		}
 	}
 
-	for (index lineIndex = highLineBound + 1; lineIndex < height; ++lineIndex) {
-		inflateLine(lineIndex, resultBuffer[lineIndex], colors.background);
+	for (index line = 0; line < height; ++line) {
+		inflateLine(line, from, count);
 	}
-}
 
-void WaveFormDrawer::inflateLine(index line, array_span<IntColor> dest, IntColor backgroundColor) const {
-	const index realWidth = width - borderSize;
+	newStripsCount = 0;
+	fullRedrawNeeded = false;
+}
 
-	const index fadeWidth = index(realWidth * fading);
-	const index flatWidth = realWidth - fadeWidth;
+void WaveFormDrawer::updateLineBackgrounds() {
+	lineBackgrounds.resize(height);
+	for (index line = 0; line < height; ++line) {
+		lineBackgrounds[line] = colors.background;
+	}
 
-	constexpr uint32_t halfPrecision = 8;
-	IntMixer<int_fast32_t, halfPrecision * 2> mixer;
+	if (lineDrawingPolicy == LineDrawingPolicy::eNEVER) {
+		return;
+	}
 
-	int_fast32_t fadeDistance = 1 << halfPrecision;
-	const int_fast32_t fadeDistanceStep = int_fast32_t(std::round(fadeDistance / (realWidth * fading)));
+	const index centerLineIndex = interpolator.toValueD(0.0);
+	const index lowLineBound = std::max<index>(centerLineIndex - (lineThickness - 1) / 2, 0);
+	const index highLineBound = std::min(centerLineIndex + (lineThickness) / 2, height - 1);
+	for (index line = lowLineBound; line <= highLineBound; ++line) {
+		lineBackgrounds[line] = colors.line;
+	}
+}
 
-	index fadeBeginIndex = minMaxBuffer.getPastLastStripIndex() + borderSize;
-	if (fadeBeginIndex >= width) {
-		fadeBeginIndex -= width;
+void WaveFormDrawer::pushWaveStrip(MinMax minMax) {
+	for (index line = 0; line < height; ++line) {
+		stripBuffer[line] = getWaveColor(line, minMax);
 	}
+	waveBuffer.pushStrip(stripBuffer);
 
-	index flatBeginIndex = fadeBeginIndex + fadeWidth;
+	newStripsCount++;
+}
 
-	if (flatBeginIndex >= width) {
-		for (index i = fadeBeginIndex; i < width; i++) {
-			mixer.setFactorWarped(fadeDistance * fadeDistance);
-			const auto sc = isWaveAt(i, line) ? colors.wave : backgroundColor;
-			dest[i] = backgroundColor.mixWith(sc, mixer);
+void WaveFormDrawer::redrawWaveBuffer() {
+	const auto minMaxLine = minMaxBuffer.getPixels()[0];
 
-			fadeDistance -= fadeDistanceStep;
+	// strips are pushed starting from the oldest one, so that after a full circle each of them is at its place
+	index column = minMaxBuffer.getPastLastStripIndex();
+	for (index i = 0; i < width; i++) {
+		const auto minMax = minMaxLine[column];
+		for (index line = 0; line < height; ++line) {
+			stripBuffer[line] = getWaveColor(line, minMax);
 		}
+		waveBuffer.pushStrip(stripBuffer);
 
-		fadeBeginIndex = 0;
-		flatBeginIndex -= width;
+		column++;
+		if (column >= width) {
+			column = 0;
+		}
 	}
+}
 
-	for (index i = fadeBeginIndex; i < flatBeginIndex; i++) {
-		mixer.setFactorWarped(fadeDistance * fadeDistance);
-		const auto sc = isWaveAt(i, line) ? colors.wave : backgroundColor;
-		dest[i] = backgroundColor.mixWith(sc, mixer);
+void WaveFormDrawer::inflateLine(index line, index from, index count) {
+	auto dest = resultBuffer[line];
 
-		fadeDistance -= fadeDistanceStep;
+	if (isLineAlwaysDrawn(line)) {
+		const index firstPartCount = std::min(count, width - from);
+		std::fill_n(dest.data() + from, firstPartCount, colors.line);
+		std::fill_n(dest.data(), count - firstPartCount, colors.line);
+		return;
 	}
 
-	index borderBeginIndex = flatBeginIndex + flatWidth;
-	if (borderBeginIndex >= width) {
-		for (index i = flatBeginIndex; i < width; i++) {
-			auto sc = isWaveAt(i, line) ? colors.wave : backgroundColor;
-			dest[i] = sc;
-		}
+	const auto source = waveBuffer.getPixels()[line];
+	const auto backgroundColor = lineBackgrounds[line];
 
-		flatBeginIndex = 0;
-		borderBeginIndex -= width;
-	}
+	const index realWidth = width - borderSize;
+	const index fadeWidth = index(realWidth * fading);
+	const index fadeEnd = borderSize + fadeWidth;
+
+	constexpr uint32_t halfPrecision = 8;
+	IntMixer<int_fast32_t, halfPrecision * 2> mixer;
+
+	const int_fast32_t fadeDistanceStep =
+		fadeWidth == 0 ? 0 : int_fast32_t(std::round((1 << halfPrecision) / (realWidth * fading)));
 
-	for (index i = flatBeginIndex; i < borderBeginIndex; i++) {
-		auto sc = isWaveAt(i, line) ? colors.wave : backgroundColor;
-		dest[i] = sc;
+	// distance from the border, which is drawn right after the last strip
+	index distance = from - minMaxBuffer.getPastLastStripIndex();
+	if (distance < 0) {
+		distance += width;
 	}
 
-	const auto border = colors.border;
-	index borderEndIndex = borderBeginIndex + borderSize;
-	if (borderEndIndex >= width) {
-		for (index i = borderBeginIndex; i < width; i++) {
-			dest[i] = border;
+	index column = from;
+	while (count > 0) {
+		index runLength = std::min(count, width - column);
+
+		if (distance < borderSize) {
+			runLength = std::min(runLength, borderSize - distance);
+			std::fill_n(dest.data() + column, runLength, colors.border);
+		} else if (distance < fadeEnd) {
+			runLength = std::min(runLength, fadeEnd - distance);
+			for (index i = 0; i < runLength; i++) {
+				const auto fadeIndex = int_fast32_t(distance - borderSize + i);
+				const int_fast32_t fadeDistance = (1 << halfPrecision) - fadeIndex * fadeDistanceStep;
+				mixer.setFactorWarped(fadeDistance * fadeDistance);
+				dest[column + i] = backgroundColor.mixWith(source[column + i], mixer);
+			}
+		} else {
+			runLength = std::min(runLength, width - distance);
+			std::copy_n(source.data() + column, runLength, dest.data() + column);
 		}
-		borderBeginIndex = 0;
-		borderEndIndex -= width;
-	}
-	for (index i = borderBeginIndex; i < borderEndIndex; i++) {
-		dest[i] = border;
+
+		column += runLength;
+		if (column >= width) {
+			column -= width;
+		}
+		distance += runLength;
+		if (distance >= width) {
+			distance -= width;
+		}
+		count -= runLength;
 	}
 }
 
-bool WaveFormDrawer::isWaveAt(index i, index line) const {
-	const auto minMax = minMaxBuffer.getPixels()[0][i];
-	return line >= minMax.minPixel && line <= minMax.maxPixel;
+bool WaveFormDrawer::isLineAlwaysDrawn(index line) const {
+	if (lineDrawingPolicy != LineDrawingPolicy::eALWAYS) {
+		return false;
+	}
+
+	const index centerLineIndex = interpolator.toValueD(0.0);
+	const index lowLineBound = centerLineIndex - (lineThickness - 1) / 2;
+	const index highLineBound = centerLineIndex + (lineThickness) / 2;
+	return line >= lowLineBound && line <= highLineBound;
 }
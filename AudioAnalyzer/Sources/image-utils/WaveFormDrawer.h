@@ -57,11 +57,23 @@ namespace rxtd::utils {
 		};
 
 		StripedImage<MinMax> minMaxBuffer{ };
+		// wave without fading and border
+		// it has the same layout as #minMaxBuffer, so each strip only needs to be drawn once
+		StripedImage<IntColor> waveBuffer{ };
+		std::vector<IntColor> stripBuffer;
+		// color of each line where there is no wave
+		std::vector<IntColor> lineBackgrounds;
 		Vector2D<IntColor> resultBuffer{ };
 		DiscreetInterpolator interpolator;
 
+		// strips that were added since last #inflate call
+		index newStripsCount = 0;
+		// waveBuffer needs to be redrawn from scratch after parameters has changed
+		bool fullRedrawNeeded = true;
+
 		index width{ };
 		index height{ };
+		bool stationary = false;
 
 		LineDrawingPolicy lineDrawingPolicy = LineDrawingPolicy::eNEVER;
 		bool connected = false;
@@ -90,6 +102,9 @@ namespace rxtd::utils {
 			if (lineThickness == 0) {
 				lineDrawingPolicy = LineDrawingPolicy::eNEVER;
 			}
+
+			updateLineBackgrounds();
+			fullRedrawNeeded = true;
 		}
 
 		void setImageParams(index width, index height, bool stationary);
@@ -111,9 +126,21 @@ namespace rxtd::utils {
 		void inflate();
 
 	private:
-		void inflateLine(index line, array_span<IntColor> dest, IntColor backgroundColor) const;
+		void updateLineBackgrounds();
+
+		void pushWaveStrip(MinMax minMax);
+
+		void redrawWaveBuffer();
+
+		// draws count columns starting from the column #from, wrapping around the end of the image
+		void inflateLine(index line, index from, index count);
+
+		[[nodiscard]]
+		bool isLineAlwaysDrawn(index line) const;
 
 		[[nodiscard]]
-		bool isWaveAt(index i, index line) const;
+		IntColor getWaveColor(index line, MinMax minMax) const {
+			return line >= minMax.minPixel && line <= minMax.maxPixel ? colors.wave : lineBackgrounds[line];
+		}
 	};
 }
@@ -80,6 +80,17 @@ void ChannelMixer::saveChannelsData(utils::array2d_view<float> channelsData) {
 	}
 }
 
+array_view<array_span<float>> ChannelMixer::allocateChannelsData(index sourceChannelsCount, index framesCount) {
+	discardedData.resize(framesCount);
+	writeSpans.assign(sourceChannelsCount, { discardedData.data(), framesCount });
+
+	for (auto channel : layout.ordered()) {
+		writeSpans[layout.indexOf(channel).value()] = channels[channel].allocateNext(framesCount);
+	}
+
+	return writeSpans;
+}
+
 void ChannelMixer::createAuto() {
 	if (aliasOfAuto != Channel::eAUTO) {
 		return;
@@ -97,6 +108,7 @@ void ChannelMixer::createAuto() {
 
 	const index size = bufferFirst.size();
 	auto writeBuffer = channels[Channel::eAUTO].allocateNext(size);
+	std::fill(writeBuffer.begin(), writeBuffer.end(), 0.0f);
 
 	for (index i = 0; i < size; ++i) {
 		if (frontLeft) { writeBuffer[i] += bufferFirst[i]; }
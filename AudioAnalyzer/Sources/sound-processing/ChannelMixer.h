@@ -9,13 +9,15 @@
 
 #pragma once
 #include "device-management/MyWaveFormat.h"
-#include "GrowingVector.h"
+#include "RingBuffer.h"
 #include "Vector2D.h"
 
 namespace rxtd::audio_analyzer {
 	class ChannelMixer {
 		ChannelLayout layout;
-		std::map<Channel, utils::GrowingVector<float>> channels;
+		std::map<Channel, utils::RingBuffer<float>> channels;
+		std::vector<array_span<float>> writeSpans;
+		std::vector<float> discardedData;
 		Channel aliasOfAuto = Channel::eAUTO;
 		bool frontLeft = false;
 		bool frontRight = false;
@@ -31,6 +33,14 @@ namespace rxtd::audio_analyzer {
 		void setLayout(const ChannelLayout& _layout);
 
 		void saveChannelsData(utils::array2d_view<float> channelsData);
+
+		// Allocates next #framesCount samples in each channel and returns them to be filled in place.
+		// Result has one span per source channel, in source order.
+		// Source channels that are not in the layout are mapped to a shared scratch buffer.
+		// Spans are only valid until next call.
+		[[nodiscard]]
+		array_view<array_span<float>> allocateChannelsData(index sourceChannelsCount, index framesCount);
+
 		void createAuto();
 
 		[[nodiscard]]
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "PerformanceLog.h"
+
+#include "my-windows.h"
+
+using namespace audio_analyzer;
+
+void PerformanceLog::setParams(string path, index rowsCount) {
+	stop();
+
+	filePath = std::move(path);
+	maxRowsCount = std::max<index>(rowsCount, 1);
+
+	pendingRows.clear();
+	pendingRowsCount = 0;
+	queuedRows.clear();
+	queuedRowsCount = 0;
+	stopRequest = false;
+
+	file.reset();
+	fileRowsCount = 0;
+
+	startTime = clock::now();
+	lastFlushTime = startTime;
+
+	if (isEnabled()) {
+		thread = std::thread{ [this]() { threadFunction(); } };
+	}
+}
+
+void PerformanceLog::write(const ProcessingOrchestrator& orchestrator) {
+	using namespace std::chrono_literals;
+
+	if (!isEnabled()) {
+		return;
+	}
+
+	const auto now = clock::now();
+	const double timeMs = std::chrono::duration<double, std::milli>{ now - startTime }.count();
+
+	orchestrator.visitHandlerTimings([&](isview procName, Channel channel, isview handlerName, const auto& timing) {
+		const auto info = timing.getInfo();
+		bp.print(
+			L"{},{},{},{},{},{},{},{}",
+			timeMs,
+			procName % csView(), ChannelUtils::getTechnicalName(channel), handlerName % csView(),
+			info.lastMs, info.averageMs, info.p99Ms, info.killsCount
+		);
+		pendingRows += bp.getBufferView();
+		pendingRows += L"\r\n";
+		pendingRowsCount++;
+	});
+
+	if (now - lastFlushTime >= 1s) {
+		flush();
+		lastFlushTime = now;
+	}
+}
+
+void PerformanceLog::flush() {
+	if (pendingRowsCount == 0 || !thread.joinable()) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock{ mutex };
+	// if writer thread is still busy with previous rows, new rows are added to them
+	queuedRows += pendingRows;
+	queuedRowsCount += pendingRowsCount;
+	lock.unlock();
+	wakeVariable.notify_one();
+
+	pendingRows.clear();
+	pendingRowsCount = 0;
+}
+
+void PerformanceLog::stop() {
+	if (!thread.joinable()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		stopRequest = true;
+	}
+	wakeVariable.notify_one();
+
+	thread.join();
+}
+
+void PerformanceLog::threadFunction() {
+	std::unique_lock<std::mutex> lock{ mutex };
+	string rows;
+
+	while (true) {
+		wakeVariable.wait(lock, [&] { return stopRequest || queuedRowsCount != 0; });
+		if (queuedRowsCount == 0) {
+			// rows that were queued before the stop request are still written
+			file.reset();
+			return;
+		}
+
+		// buffers are swapped, so that both of them keep their memory
+		rows.clear();
+		std::swap(rows, queuedRows);
+		const index rowsCount = queuedRowsCount;
+		queuedRowsCount = 0;
+
+		lock.unlock();
+		writeRows(rows, rowsCount);
+		lock.lock();
+	}
+}
+
+void PerformanceLog::writeRows(sview rows, index rowsCount) {
+	if (!file.has_value()) {
+		openFile();
+	}
+
+	if (!file->isValid()) {
+		// rows are lost, try again with the next ones
+		file.reset();
+		return;
+	}
+
+	// names are ASCII in practice, but let's not break the file if they aren't
+	const int size = WideCharToMultiByte(CP_UTF8, 0, rows.data(), int(rows.size()), nullptr, 0, nullptr, nullptr);
+	utf8Buffer.resize(size);
+	WideCharToMultiByte(CP_UTF8, 0, rows.data(), int(rows.size()), utf8Buffer.data(), size, nullptr, nullptr);
+
+	file->write(utf8Buffer.data(), index(utf8Buffer.size()));
+	fileRowsCount += rowsCount;
+
+	if (!file->isValid()) {
+		file.reset();
+		return;
+	}
+
+	if (fileRowsCount >= maxRowsCount) {
+		file.reset();
+		utils::FileWrapper::replaceFile(filePath, filePath + L".old");
+	}
+}
+
+void PerformanceLog::openFile() {
+	file.emplace(filePath.c_str());
+	fileRowsCount = 0;
+
+	if (!file->isValid()) {
+		return;
+	}
+
+	const std::string header = "time ms,processing,channel,handler,last ms,average ms,p99 ms,kills\r\n";
+	file->write(header.data(), index(header.size()));
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include "ProcessingOrchestrator.h"
+#include "windows-wrappers/FileWrapper.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace rxtd::audio_analyzer {
+	// Periodically appends rows of handler timings to a CSV file that is kept open.
+	// When file gets N rows it is moved to "<file>.old" and a new file is started,
+	// so last N rows are always on disk, and disk usage is limited no matter how long plugin runs.
+	//
+	// File is written in a separate thread, so that disk access doesn't affect the timings that are logged.
+	class PerformanceLog : NonMovableBase {
+		using clock = SoundHandler::clock;
+
+		string filePath;
+		index maxRowsCount{ };
+
+		// rows since last flush
+		string pendingRows;
+		index pendingRowsCount = 0;
+
+		clock::time_point startTime;
+		clock::time_point lastFlushTime;
+		utils::BufferPrinter bp;
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable wakeVariable;
+		bool stopRequest = false;
+
+		// rows that were handed over to the writer thread
+		string queuedRows;
+		index queuedRowsCount = 0;
+
+		// fields below are only used by the writer thread
+		std::optional<utils::FileWrapper> file;
+		index fileRowsCount = 0;
+		std::string utf8Buffer;
+
+	public:
+		PerformanceLog() = default;
+
+		// rows that were already logged are written before the object is destroyed
+		~PerformanceLog() {
+			flush();
+			stop();
+		}
+
+		// empty path disables log
+		void setParams(string path, index rowsCount);
+
+		[[nodiscard]]
+		bool isEnabled() const {
+			return !filePath.empty();
+		}
+
+		// adds one row for each handler in each channel
+		void write(const ProcessingOrchestrator& orchestrator);
+
+	private:
+		void flush();
+		void stop();
+		void threadFunction();
+		void writeRows(sview rows, index rowsCount);
+		void openFile();
+	};
+}
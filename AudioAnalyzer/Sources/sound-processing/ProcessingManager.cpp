@@ -13,47 +13,125 @@
 
 using namespace audio_analyzer;
 
+void ProcessingManager::HandlerTiming::add(clock::duration value, bool killTimeReached) {
+	const double valueMs = std::chrono::duration<double, std::milli>{ value }.count();
+
+	total += value;
+	max = std::max(max, value);
+	last = value;
+	averageMs = callsCount == 0 ? valueMs : averageMs + (valueMs - averageMs) * averageFactor;
+	window[callsCount % windowSize] = float(valueMs);
+	callsCount++;
+	if (killTimeReached) {
+		killsCount++;
+	}
+
+	if (callsCount <= p99UpdatePeriod || callsCount % p99UpdatePeriod == 0) {
+		updateP99();
+	}
+}
+
+SoundHandler::PerformanceInfo ProcessingManager::HandlerTiming::getInfo() const {
+	SoundHandler::PerformanceInfo result;
+	result.lastMs = std::chrono::duration<double, std::milli>{ last }.count();
+	result.averageMs = averageMs;
+	result.p99Ms = p99Ms;
+	result.killsCount = killsCount;
+	result.callsCount = callsCount;
+	return result;
+}
+
+void ProcessingManager::HandlerTiming::updateP99() {
+	const index count = std::min(callsCount, windowSize);
+	auto sorted = window;
+	const index p99Index = index(double(count - 1) * 0.99);
+	std::nth_element(sorted.begin(), sorted.begin() + p99Index, sorted.begin() + count);
+	p99Ms = sorted[p99Index];
+}
+
 void ProcessingManager::setParams(
 	utils::Rainmeter::Logger logger,
 	const ParamParser::ProcessingData& pd,
 	index legacyNumber,
 	index sampleRate, ChannelLayout layout,
-	Snapshot& snapshot
+	Snapshot& snapshot,
+	SharingSource sharingSource
 ) {
-	std::set<Channel> channels;
-	for (const auto channel : pd.channels) {
-		if (channel == Channel::eAUTO || layout.contains(channel)) {
-			channels.insert(channel);
-		}
-	}
+	const auto channels = getActiveChannels(pd, layout);
 
-	if (pd.targetRate == 0) {
-		resamplingDivider = 1;
-	} else {
-		const auto ratio = static_cast<double>(sampleRate) / pd.targetRate;
-		resamplingDivider = ratio > 1 ? static_cast<index>(ratio) : 1;
-	}
-	const index finalSampleRate = sampleRate / resamplingDivider;
+	waveOwner = sharingSource.manager;
+	sharedHandlerNames.clear();
 
 	auto oldChannelMap = std::exchange(channelMap, { });
 
-	for (auto channel : channels) {
-		auto& newChannelStruct = channelMap[channel];
-		newChannelStruct.filter = pd.fcc.getInstance(double(finalSampleRate));
-		newChannelStruct.downsampleHelper.setFactor(resamplingDivider);
+	if (waveOwner != nullptr) {
+		resamplingType = ResamplingType::NONE;
+		finalSampleRate = waveOwner->finalSampleRate;
+		filter = { };
+		for (auto channel : channels) {
+			channelMap[channel];
+		}
+	} else {
+		resamplingDivider = 1;
+		finalSampleRate = sampleRate;
+		if (pd.targetRate == 0 || pd.targetRate >= sampleRate) {
+			resamplingType = ResamplingType::NONE;
+		} else if (!pd.exactResampling) {
+			const auto ratio = static_cast<double>(sampleRate) / pd.targetRate;
+			resamplingDivider = static_cast<index>(ratio);
+			resamplingType = resamplingDivider > 1 ? ResamplingType::INTEGER : ResamplingType::NONE;
+			finalSampleRate = sampleRate / resamplingDivider;
+		} else {
+			resamplingType = ResamplingType::RATIONAL;
+		}
+
+		for (auto channel : channels) {
+			auto& newChannelStruct = channelMap[channel];
+			switch (resamplingType) {
+			case ResamplingType::NONE: break;
+			case ResamplingType::INTEGER:
+				newChannelStruct.downsampleHelper.setFactor(resamplingDivider);
+				break;
+			case ResamplingType::RATIONAL:
+				newChannelStruct.resampler.setParams(sampleRate, pd.targetRate, pd.resamplingQuality);
+				finalSampleRate = std::lround(newChannelStruct.resampler.getOutputRate());
+				break;
+			}
+		}
+		filter = pd.fcc.getInstance(double(finalSampleRate), pd.filterPrecision);
 	}
 
 	order.clear();
 	for (auto& handlerName : pd.handlersInfo.order) {
 		auto& patchInfo = pd.handlersInfo.patchers.find(handlerName)->second;
 
+		if (const auto sharedName = findSharedHandler(patchInfo, sharingSource);
+			!sharedName.empty()) {
+			sharedHandlerNames[handlerName] = sharedName;
+
+			for (auto channel : channels) {
+				auto& ownerChannelStruct = waveOwner->channelMap.find(channel)->second;
+				auto& ownerChannelSnapshot = sharingSource.snapshot->find(channel)->second;
+
+				channelMap[channel].sharedHandlers[handlerName] =
+					ownerChannelStruct.handlerMap.find(sharedName)->second.get();
+				const auto& ownerHandlerSnapshot = ownerChannelSnapshot.find(sharedName)->second;
+				auto& handlerSnapshot = snapshot[channel][handlerName];
+				handlerSnapshot.values = ownerHandlerSnapshot.values;
+				handlerSnapshot.handlerSpecificData.share(ownerHandlerSnapshot.handlerSpecificData);
+			}
+
+			order.push_back(handlerName);
+			continue;
+		}
+
 		bool handlerIsValid = true;
 		for (auto channel : channels) {
-			auto& channelDataNew = channelMap[channel].handlerMap;
+			auto& channelStructNew = channelMap[channel];
 			auto handlerPtr = patchInfo.fun(std::move(oldChannelMap[channel].handlerMap[handlerName]));
 
 			auto cl = logger.context(L"handler '{}': ", handlerName);
-			HandlerFinderImpl hf{ channelDataNew };
+			HandlerFinderImpl hf{ channelStructNew };
 			const bool success = handlerPtr->patch(
 				patchInfo.params, patchInfo.sources,
 				finalSampleRate, legacyNumber,
@@ -68,7 +146,7 @@ void ProcessingManager::setParams(
 				break;
 			}
 
-			channelDataNew[handlerName] = std::move(handlerPtr);
+			channelStructNew.handlerMap[handlerName] = std::move(handlerPtr);
 		}
 
 		if (handlerIsValid) {
@@ -86,41 +164,196 @@ void ProcessingManager::setParams(
 	utils::MapUtils::intersectKeyCollection(snapshot, channels);
 	for (auto& [channel, channelStruct] : channelMap) {
 		auto& channelSnapshot = snapshot[channel];
-		utils::MapUtils::intersectKeyCollection(channelSnapshot, channelStruct.handlerMap);
+		utils::MapUtils::intersectKeysWithPredicate(channelSnapshot, [&](const istring& handlerName) {
+			return channelStruct.handlerMap.find(handlerName) != channelStruct.handlerMap.end()
+				|| channelStruct.sharedHandlers.find(handlerName) != channelStruct.sharedHandlers.end();
+		});
+	}
+
+	for (auto& [channel, channelStruct] : channelMap) {
+		channelStruct.timings.resize(order.size());
+	}
+}
+
+void ProcessingManager::finishConfiguration() {
+	for (auto& [channel, channelStruct] : channelMap) {
+		for (auto& [handlerName, handler] : channelStruct.handlerMap) {
+			handler->finishConfiguration();
+		}
+	}
+}
+
+void ProcessingManager::shareSnapshot(Snapshot& snapshot, const Snapshot& sharedSnapshot) const {
+	for (auto& [channel, channelSnapshot] : snapshot) {
+		const auto& sharedChannelSnapshot = sharedSnapshot.find(channel)->second;
+		for (const auto& [handlerName, sharedName] : sharedHandlerNames) {
+			channelSnapshot[handlerName].handlerSpecificData.share(
+				sharedChannelSnapshot.find(sharedName)->second.handlerSpecificData
+			);
+		}
 	}
+}
 
-	for (auto& [channel, channelHandlers] : channelMap) {
-		for (auto& handlerName : order) {
-			channelHandlers.handlerMap[handlerName]->finishConfiguration();
+std::set<Channel> ProcessingManager::getActiveChannels(const ParamParser::ProcessingData& pd, ChannelLayout layout) {
+	std::set<Channel> channels;
+	for (const auto channel : pd.channels) {
+		if (channel == Channel::eAUTO || layout.contains(channel)) {
+			channels.insert(channel);
 		}
 	}
+	return channels;
 }
 
-void ProcessingManager::process(const ChannelMixer& mixer, clock::time_point killTime, Snapshot& snapshot) {
+bool ProcessingManager::isSameWave(const ParamParser::ProcessingData& pd1, const ParamParser::ProcessingData& pd2) {
+	return pd1.rawFccDescription == pd2.rawFccDescription
+		&& pd1.fcc == pd2.fcc
+		&& pd1.filterPrecision == pd2.filterPrecision
+		&& pd1.targetRate == pd2.targetRate
+		&& pd1.exactResampling == pd2.exactResampling
+		&& pd1.resamplingQuality == pd2.resamplingQuality;
+}
+
+isview ProcessingManager::findSharedHandler(const PatchInfo& patchInfo, const SharingSource& sharingSource) const {
+	if (waveOwner == nullptr) {
+		return { };
+	}
+
+	// image writers create files named after processing, so each processing needs its own
+	if (patchInfo.externalMethods.finish != nullptr) {
+		return { };
+	}
+
+	for (const auto& ownerHandlerName : waveOwner->order) {
+		const auto& ownerPatchInfo = sharingSource.data->handlersInfo.patchers.find(ownerHandlerName)->second;
+		if (ownerPatchInfo != patchInfo) {
+			continue;
+		}
+
+		// source must also be shared, otherwise handlers get different input
+		if (!patchInfo.sources.empty()) {
+			const auto iter = sharedHandlerNames.find(patchInfo.sources[0]);
+			if (iter == sharedHandlerNames.end() || iter->second != ownerPatchInfo.sources[0]) {
+				continue;
+			}
+		}
+
+		return ownerHandlerName;
+	}
+
+	return { };
+}
+
+void ProcessingManager::process(
+	const ChannelMixer& mixer, clock::time_point killTime,
+	Snapshot& snapshot, const Snapshot* sharedSnapshot
+) {
+	prepareChannels(mixer);
 	for (auto& [channel, channelStruct] : channelMap) {
-		auto& channelSnapshot = snapshot[channel];
+		const ChannelSnapshot* sharedChannelSnapshot =
+			sharedSnapshot == nullptr ? nullptr : &sharedSnapshot->find(channel)->second;
+		processChannel(channelStruct, killTime, snapshot[channel], sharedChannelSnapshot);
+	}
+}
 
-		SoundHandler::ProcessContext context{ };
+void ProcessingManager::collectJobs(
+	const ChannelMixer& mixer,
+	Snapshot& snapshot, const Snapshot* sharedSnapshot,
+	std::vector<ChannelJob>& jobs
+) {
+	// filter needs all channels at once, so it can't be a part of a job
+	prepareChannels(mixer);
 
-		if (auto wave = mixer.getChannelPCM(channel);
-			resamplingDivider <= 1) {
-			context.originalWave = wave;
+	// all map lookups happen here, in the calling thread,
+	// so that jobs only touch their own channel data
+	for (auto& [channel, channelStruct] : channelMap) {
+		ChannelJob job;
+		job.manager = this;
+		job.channelStruct = &channelStruct;
+		job.snapshot = &snapshot[channel];
+		if (waveOwner == nullptr) {
+			job.waveSource = &channelStruct;
 		} else {
+			job.sharedSnapshot = &sharedSnapshot->find(channel)->second;
+			job.waveSource = &waveOwner->channelMap.find(channel)->second;
+		}
+		jobs.push_back(job);
+	}
+}
+
+void ProcessingManager::prepareChannels(const ChannelMixer& mixer) {
+	if (waveOwner != nullptr) {
+		// wave owner is always prepared before this processing
+		for (auto& [channel, channelStruct] : channelMap) {
+			const auto& ownerChannelStruct = waveOwner->channelMap.find(channel)->second;
+			channelStruct.originalWave = ownerChannelStruct.originalWave;
+			channelStruct.wave = ownerChannelStruct.wave;
+		}
+		return;
+	}
+
+	filterChannels.clear();
+
+	for (auto& [channel, channelStruct] : channelMap) {
+		switch (auto wave = mixer.getChannelPCM(channel); resamplingType) {
+		case ResamplingType::NONE:
+			channelStruct.originalWave = wave;
+			break;
+		case ResamplingType::INTEGER: {
 			const index nextBufferSize = channelStruct.downsampleHelper.pushData(wave);
-			downsampledBuffer.resize(nextBufferSize);
-			channelStruct.downsampleHelper.downsample(downsampledBuffer);
-			context.originalWave = downsampledBuffer;
+			channelStruct.downsampledBuffer.resize(nextBufferSize);
+			channelStruct.downsampleHelper.downsample(channelStruct.downsampledBuffer);
+			channelStruct.originalWave = channelStruct.downsampledBuffer;
+			break;
+		}
+		case ResamplingType::RATIONAL: {
+			const index nextBufferSize = channelStruct.resampler.pushData(wave);
+			channelStruct.downsampledBuffer.resize(nextBufferSize);
+			channelStruct.resampler.resample(channelStruct.downsampledBuffer);
+			channelStruct.originalWave = channelStruct.downsampledBuffer;
+			break;
 		}
-		context.originalWave.transferToVector(filteredBuffer);
+		}
+
+		channelStruct.originalWave.transferToVector(channelStruct.filteredBuffer);
+		channelStruct.wave = channelStruct.filteredBuffer;
+		filterChannels.emplace_back(channelStruct.filteredBuffer);
+	}
 
-		channelStruct.filter.applyInPlace(filteredBuffer);
+	filter.apply(filterChannels);
+}
+
+void ProcessingManager::processChannel(
+	ChannelStruct& channelStruct,
+	clock::time_point killTime,
+	ChannelSnapshot& channelSnapshot,
+	const ChannelSnapshot* sharedSnapshot
+) {
+	SoundHandler::ProcessContext context{ };
+	context.originalWave = channelStruct.originalWave;
+	context.wave = channelStruct.wave;
+	context.killTime = killTime;
 
-		context.wave = filteredBuffer;
-		context.killTime = killTime;
+	for (index i = 0; i < index(order.size()); i++) {
+		auto& handlerName = order[i];
 
-		for (auto& handlerName : order) {
+		auto& handlerSnapshot = channelSnapshot[handlerName];
+		auto& timing = channelStruct.timings[i];
+
+		const auto handlerBeginTime = clock::now();
+		if (const auto sharedIter = sharedHandlerNames.find(handlerName);
+			sharedIter != sharedHandlerNames.end()) {
+			// handler is already processed by the wave owner, only its results are needed
+			const auto& sharedHandlerSnapshot = sharedSnapshot->find(sharedIter->second)->second;
+			sharedHandlerSnapshot.values.transferToVector(handlerSnapshot.values);
+			handlerSnapshot.handlerSpecificData.share(sharedHandlerSnapshot.handlerSpecificData);
+		} else {
 			auto& handler = *channelStruct.handlerMap[handlerName];
-			handler.process(context, channelSnapshot[handlerName]);
+			handler.process(context, handlerSnapshot);
 		}
+		const auto handlerEndTime = clock::now();
+
+		const bool killTimeReached = handlerBeginTime <= killTime && killTime < handlerEndTime;
+		timing.add(handlerEndTime - handlerBeginTime, killTimeReached);
+		handlerSnapshot.performance = timing.getInfo();
 	}
 }
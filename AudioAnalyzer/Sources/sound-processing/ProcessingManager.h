@@ -8,12 +8,14 @@
  */
 
 #pragma once
+#include <array>
 #include <chrono>
 
 #include "Channel.h"
 #include "../ParamParser.h"
 #include "ChannelMixer.h"
 #include "../audio-utils/DownsampleHelper.h"
+#include "../audio-utils/RationalResampler.h"
 
 namespace rxtd::audio_analyzer {
 	class ProcessingManager {
@@ -25,33 +27,120 @@ namespace rxtd::audio_analyzer {
 
 		using HandlerMap = std::map<istring, std::unique_ptr<SoundHandler>, std::less<>>;
 
+		// statistics of SoundHandler#process calls
+		struct HandlerTiming {
+			static constexpr index windowSize = 256;
+			// p99 is only recalculated every few calls, because it needs sorting
+			static constexpr index p99UpdatePeriod = 16;
+			static constexpr double averageFactor = 0.05;
+
+			clock::duration total{ };
+			clock::duration max{ };
+			clock::duration last{ };
+			double averageMs{ };
+			double p99Ms{ };
+			index callsCount{ };
+			index killsCount{ };
+
+			// ring buffer of last durations in milliseconds
+			std::array<float, windowSize> window{ };
+
+			void add(clock::duration value, bool killTimeReached);
+
+			[[nodiscard]]
+			SoundHandler::PerformanceInfo getInfo() const;
+
+		private:
+			void updateP99();
+		};
+
 		struct ChannelStruct {
 			HandlerMap handlerMap;
+			// handlers that are computed by the wave owner processing
+			std::map<istring, SoundHandler*, std::less<>> sharedHandlers;
 
-			audio_utils::FilterCascade filter;
 			audio_utils::DownsampleHelper downsampleHelper;
+			audio_utils::RationalResampler resampler;
+
+			// each channel has its own scratch buffers
+			// so that different channels can be processed concurrently
+			std::vector<float> downsampledBuffer;
+			std::vector<float> filteredBuffer;
+
+			// resampled wave of current #process call
+			array_view<float> originalWave;
+			// resampled and filtered wave of current #process call
+			array_view<float> wave;
+
+			// same order as ProcessingManager#order
+			std::vector<HandlerTiming> timings;
+		};
+
+		// Processing of one channel of one processing unit.
+		// Jobs with different #waveSource don't share any mutable data, so they can be run in any order and in any thread.
+		// Jobs with the same #waveSource must be run sequentially in the order they were collected.
+		struct ChannelJob {
+			ProcessingManager* manager{ };
+			ChannelStruct* channelStruct{ };
+			ChannelSnapshot* snapshot{ };
+			// snapshot of the same channel of the wave owner, nullptr if nothing is shared
+			const ChannelSnapshot* sharedSnapshot{ };
+			const ChannelStruct* waveSource{ };
+
+			void run(clock::time_point killTime) const {
+				manager->processChannel(*channelStruct, killTime, *snapshot, sharedSnapshot);
+			}
 		};
 
 		class HandlerFinderImpl : public HandlerFinder {
-			const HandlerMap& channelData;
+			const ChannelStruct& channelData;
 
 		public:
-			explicit HandlerFinderImpl(const HandlerMap& channelData) : channelData(channelData) {
+			explicit HandlerFinderImpl(const ChannelStruct& channelData) : channelData(channelData) {
 			}
 
 			[[nodiscard]]
 			SoundHandler* getHandler(isview id) const override {
-				const auto iter = channelData.find(id);
-				return iter == channelData.end() ? nullptr : iter->second.get();
+				if (const auto iter = channelData.handlerMap.find(id);
+					iter != channelData.handlerMap.end()) {
+					return iter->second.get();
+				}
+				if (const auto iter = channelData.sharedHandlers.find(id);
+					iter != channelData.sharedHandlers.end()) {
+					return iter->second;
+				}
+				return nullptr;
 			}
 		};
 
+		// Another processing that was configured earlier and prepares exactly the same wave.
+		// Processing that has a sharing source doesn't resample and filter anything by itself,
+		// and handlers that are the same as in the source processing are not computed twice.
+		struct SharingSource {
+			ProcessingManager* manager{ };
+			const ParamParser::ProcessingData* data{ };
+			const Snapshot* snapshot{ };
+		};
+
 	private:
 		std::vector<istring> order;
 		std::map<Channel, ChannelStruct> channelMap;
+		index finalSampleRate{ };
+
+		// nullptr if this processing prepares its wave by itself
+		ProcessingManager* waveOwner = nullptr;
+		// handlerName → name of the same handler in #waveOwner
+		std::map<istring, istring, std::less<>> sharedHandlerNames;
+
+		// filter processes all channels at once
+		audio_utils::FilterCascade filter;
+		std::vector<array_span<float>> filterChannels;
+		enum class ResamplingType {
+			NONE,
+			INTEGER,
+			RATIONAL,
+		} resamplingType{ };
 		index resamplingDivider{ };
-		std::vector<float> downsampledBuffer;
-		std::vector<float> filteredBuffer;
 
 	public:
 		void setParams(
@@ -59,9 +148,78 @@ namespace rxtd::audio_analyzer {
 			const ParamParser::ProcessingData& pd,
 			index _legacyNumber,
 			index sampleRate, ChannelLayout layout,
-			Snapshot& snapshot
+			Snapshot& snapshot,
+			SharingSource sharingSource
+		);
+
+		// must be called after all processings are configured,
+		// because processings that share handlers need to see changes in them
+		void finishConfiguration();
+
+		// points data of shared handlers in #snapshot to the data in #sharedSnapshot,
+		// which is the snapshot of the wave owner, so that copied snapshots don't refer to their originals
+		void shareSnapshot(Snapshot& snapshot, const Snapshot& sharedSnapshot) const;
+
+		// #sharedSnapshot is the snapshot of the wave owner, nullptr if there is no wave owner
+		void process(
+			const ChannelMixer& mixer, clock::time_point killTime,
+			Snapshot& snapshot, const Snapshot* sharedSnapshot
 		);
 
-		void process(const ChannelMixer& mixer, clock::time_point killTime, Snapshot& snapshot);
+		// prepares waves of all channels and appends one job per channel to the #jobs
+		void collectJobs(
+			const ChannelMixer& mixer,
+			Snapshot& snapshot, const Snapshot* sharedSnapshot,
+			std::vector<ChannelJob>& jobs
+		);
+
+		[[nodiscard]]
+		bool hasWaveOwner() const {
+			return waveOwner != nullptr;
+		}
+
+		[[nodiscard]]
+		bool hasChannels(const std::set<Channel>& channels) const {
+			for (auto channel : channels) {
+				if (channelMap.find(channel) == channelMap.end()) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// channels from #pd that will actually be processed with given #layout
+		[[nodiscard]]
+		static std::set<Channel> getActiveChannels(const ParamParser::ProcessingData& pd, ChannelLayout layout);
+
+		// returns true if resampling and filtering of both processings give the same result
+		[[nodiscard]]
+		static bool isSameWave(const ParamParser::ProcessingData& pd1, const ParamParser::ProcessingData& pd2);
+
+		// callback(Channel, isview handlerName, const HandlerTiming&)
+		template<typename Callback>
+		void visitHandlerTimings(Callback callback) const {
+			for (const auto& [channel, channelStruct] : channelMap) {
+				for (index i = 0; i < index(order.size()); i++) {
+					callback(channel, isview{ order[i] }, channelStruct.timings[i]);
+				}
+			}
+		}
+
+	private:
+		// returns name of the handler in the #waveOwner that computes the same values
+		// or empty view if there is no such handler
+		[[nodiscard]]
+		isview findSharedHandler(const PatchInfo& patchInfo, const SharingSource& sharingSource) const;
+
+		// resamples and filters waves of all channels
+		void prepareChannels(const ChannelMixer& mixer);
+
+		void processChannel(
+			ChannelStruct& channelStruct,
+			clock::time_point killTime,
+			ChannelSnapshot& channelSnapshot,
+			const ChannelSnapshot* sharedSnapshot
+		);
 	};
 }
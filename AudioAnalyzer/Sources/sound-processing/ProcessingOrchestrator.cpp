@@ -15,6 +15,7 @@ using namespace audio_analyzer;
 
 void ProcessingOrchestrator::reset() {
 	saMap.clear();
+	waveOwners.clear();
 	valid = false;
 }
 
@@ -26,24 +27,82 @@ void ProcessingOrchestrator::patch(
 	utils::MapUtils::intersectKeyCollection(saMap, patches);
 	utils::MapUtils::intersectKeyCollection(snapshot, patches);
 
+	waveOwners.clear();
 	for (const auto& [name, data] : patches) {
+		const auto sharingSource = findSharingSource(name, data, patches, channelLayout);
+
 		auto& sa = saMap[name];
 		sa.setParams(
 			logger.context(L"Proc '{}': ", name),
 			data,
 			legacyNumber, samplesPerSec, channelLayout,
-			snapshot[name]
+			snapshot[name],
+			sharingSource
 		);
 	}
 
+	for (auto& [name, sa] : saMap) {
+		sa.finishConfiguration();
+	}
+
 	valid = true;
 }
 
+ProcessingManager::SharingSource ProcessingOrchestrator::findSharingSource(
+	isview name,
+	const ParamParser::ProcessingData& data,
+	const ParamParser::ProcessingsInfoMap& patches,
+	ChannelLayout channelLayout
+) {
+	const auto channels = ProcessingManager::getActiveChannels(data, channelLayout);
+
+	// only processings that are before this one are already configured
+	for (const auto& [otherName, otherData] : patches) {
+		if (otherName == name) {
+			break;
+		}
+
+		auto& other = saMap[otherName];
+		if (other.hasWaveOwner()
+			|| !ProcessingManager::isSameWave(data, otherData)
+			|| !other.hasChannels(channels)) {
+			continue;
+		}
+
+		waveOwners[name % own()] = otherName;
+
+		ProcessingManager::SharingSource result;
+		result.manager = &other;
+		result.data = &otherData;
+		result.snapshot = &snapshot[otherName];
+		return result;
+	}
+
+	return { };
+}
+
+const ProcessingManager::Snapshot* ProcessingOrchestrator::findSharedSnapshot(isview name, const Snapshot& snap) const {
+	const auto ownerIter = waveOwners.find(name);
+	if (ownerIter == waveOwners.end()) {
+		return nullptr;
+	}
+
+	return &snap.find(ownerIter->second)->second;
+}
+
 void ProcessingOrchestrator::configureSnapshot(Snapshot& snap) const {
 	snap = snapshot;
+
+	// shared data of the copy must refer to the copy itself
+	for (const auto& [name, sa] : saMap) {
+		if (const auto sharedSnapshot = findSharedSnapshot(name, snap);
+			sharedSnapshot != nullptr) {
+			sa.shareSnapshot(snap[name], *sharedSnapshot);
+		}
+	}
 }
 
-void ProcessingOrchestrator::process(const ChannelMixer& channelMixer) {
+void ProcessingOrchestrator::process(const ChannelMixer& channelMixer, Snapshot& snap) {
 	using clock = SoundHandler::clock;
 	using namespace std::chrono_literals;
 
@@ -51,8 +110,23 @@ void ProcessingOrchestrator::process(const ChannelMixer& channelMixer) {
 	const clock::time_point killTime = processBeginTime
 		+ std::chrono::duration_cast<clock::duration>(1.0ms * killTimeoutMs);
 
-	for (auto& [name, sa] : saMap) {
-		sa.process(channelMixer, killTime, snapshot[name]);
+	if (workerPool.getWorkersCount() == 0) {
+		for (auto& [name, sa] : saMap) {
+			sa.process(channelMixer, killTime, snap[name], findSharedSnapshot(name, snap));
+		}
+	} else {
+		jobs.clear();
+		for (auto& [name, sa] : saMap) {
+			sa.collectJobs(channelMixer, snap[name], findSharedSnapshot(name, snap), jobs);
+		}
+		groupJobs();
+
+		auto runJobGroup = [&](index i) {
+			for (const auto& job : jobGroups[i]) {
+				job.run(killTime);
+			}
+		};
+		workerPool.run(jobGroupsCount, runJobGroup);
 	}
 
 	if (warnTimeMs >= 0.0) {
@@ -72,6 +146,24 @@ void ProcessingOrchestrator::process(const ChannelMixer& channelMixer) {
 	}
 }
 
-void ProcessingOrchestrator::exchangeData(Snapshot& snap) {
-	std::swap(snap, snapshot);
+void ProcessingOrchestrator::groupJobs() {
+	// jobs of processings that share data must be run sequentially,
+	// and wave owner is always collected before processings that use it
+	jobGroupsCount = 0;
+	for (const auto& job : jobs) {
+		index groupIndex = 0;
+		while (groupIndex < jobGroupsCount && jobGroups[groupIndex].front().waveSource != job.waveSource) {
+			groupIndex++;
+		}
+
+		if (groupIndex == jobGroupsCount) {
+			if (jobGroupsCount == index(jobGroups.size())) {
+				jobGroups.emplace_back();
+			}
+			jobGroups[jobGroupsCount].clear();
+			jobGroupsCount++;
+		}
+
+		jobGroups[groupIndex].push_back(job);
+	}
 }
@@ -9,6 +9,7 @@
 
 #pragma once
 #include "ProcessingManager.h"
+#include "WorkerPool.h"
 
 namespace rxtd::audio_analyzer {
 	class ProcessingOrchestrator {
@@ -22,8 +23,18 @@ namespace rxtd::audio_analyzer {
 		utils::Rainmeter::Logger logger;
 
 		std::map<istring, ProcessingManager, std::less<>> saMap;
+		// processing name → name of the processing that prepares its wave
+		std::map<istring, istring, std::less<>> waveOwners;
+		// snapshot in the state right after configuration,
+		// used as a template for snapshots that are processed
 		Snapshot snapshot;
 
+		utils::WorkerPool workerPool;
+		std::vector<ProcessingManager::ChannelJob> jobs;
+		// jobs with the same wave source, in the order of #jobs
+		std::vector<std::vector<ProcessingManager::ChannelJob>> jobGroups;
+		index jobGroupsCount{ };
+
 		bool valid = false;
 
 	public:
@@ -39,6 +50,10 @@ namespace rxtd::audio_analyzer {
 			warnTimeMs = value;
 		}
 
+		void setWorkersCount(index value) {
+			workerPool.setWorkersCount(value);
+		}
+
 		[[nodiscard]]
 		bool isValid() const {
 			return valid;
@@ -53,7 +68,31 @@ namespace rxtd::audio_analyzer {
 		);
 		void configureSnapshot(Snapshot& snap) const;
 
-		void process(const ChannelMixer& channelMixer);
-		void exchangeData(Snapshot& snap);
+		// #snap must be configured with #configureSnapshot after last #patch
+		void process(const ChannelMixer& channelMixer, Snapshot& snap);
+
+		// callback(isview procName, Channel, isview handlerName, const ProcessingManager::HandlerTiming&)
+		template<typename Callback>
+		void visitHandlerTimings(Callback callback) const {
+			for (const auto& [name, sa] : saMap) {
+				sa.visitHandlerTimings([&](Channel channel, isview handlerName, const auto& timing) {
+					callback(isview{ name }, channel, handlerName, timing);
+				});
+			}
+		}
+
+	private:
+		[[nodiscard]]
+		ProcessingManager::SharingSource findSharingSource(
+			isview name,
+			const ParamParser::ProcessingData& data,
+			const ParamParser::ProcessingsInfoMap& patches,
+			ChannelLayout channelLayout
+		);
+
+		[[nodiscard]]
+		const ProcessingManager::Snapshot* findSharedSnapshot(isview name, const Snapshot& snap) const;
+
+		void groupJobs();
 	};
 }
@@ -8,6 +8,7 @@
  */
 
 #include "CaptureManager.h"
+#include <filesystem>
 
 using namespace audio_analyzer;
 
@@ -28,9 +29,15 @@ void CaptureManager::disconnect() {
 	snapshot.state = State::eMANUALLY_DISCONNECTED;
 	audioCaptureClient = { };
 	sessionEventsWrapper = { };
+	fileReader = { };
 }
 
 CaptureManager::State CaptureManager::setSourceAndGetState(const SourceDesc& desc) {
+	if (desc.type == SourceDesc::Type::eFILE) {
+		return openFile(desc.id);
+	}
+	fileReader = { };
+
 	audioDeviceHandle = getDevice(desc);
 
 	if (!audioDeviceHandle.isValid()) {
@@ -44,6 +51,8 @@ CaptureManager::State CaptureManager::setSourceAndGetState(const SourceDesc& des
 		case SourceDesc::Type::eID:
 			logger.error(L"Audio device with id '{}' is not found", desc.id);
 			break;
+		case SourceDesc::Type::eFILE:
+			break;
 		}
 
 		return State::eDEVICE_CONNECTION_ERROR;
@@ -125,13 +134,7 @@ CaptureManager::State CaptureManager::setSourceAndGetState(const SourceDesc& des
 	}
 
 	snapshot.formatString = makeFormatString(snapshot.format);
-	snapshot.channelsString.clear();
-	auto channels = snapshot.format.channelLayout.ordered();
-	for (int i = 0; i < channels.size() - 1; ++i) {
-		snapshot.channelsString += ChannelUtils::getTechnicalName(channels[i]);
-		snapshot.channelsString += L',';
-	}
-	snapshot.channelsString += ChannelUtils::getTechnicalName(channels.back());
+	snapshot.channelsString = makeChannelsString(snapshot.format.channelLayout);
 
 	channelMixer.setLayout(snapshot.format.channelLayout);
 
@@ -151,22 +154,68 @@ CaptureManager::State CaptureManager::setSourceAndGetState(const SourceDesc& des
 	return State::eOK;
 }
 
+CaptureManager::State CaptureManager::openFile(const string& path) {
+	audioDeviceHandle = { };
+	audioCaptureClient = { };
+	sessionEventsWrapper = { };
+
+	fileReader = utils::WaveFileReader{ path };
+	if (!fileReader.isValid()) {
+		logger.error(L"Can't read wave file '{}': {}", path, fileReader.getErrorMessage());
+		fileReader = { };
+		return State::eDEVICE_CONNECTION_ERROR;
+	}
+
+	const auto format = fileReader.getFormat();
+
+	snapshot.id = path;
+	snapshot.name = std::filesystem::path{ path }.filename().wstring();
+	snapshot.nameOnly = snapshot.name;
+	snapshot.description = L"file";
+	snapshot.type = utils::MediaDeviceType::eOUTPUT;
+	snapshot.format.samplesPerSec = format.samplesPerSec;
+	snapshot.format.channelLayout = ChannelUtils::parseLayout(format.channelMask);
+	if (snapshot.format.channelLayout.ordered().empty()) {
+		logger.error(L"zero known channels are found in the channel layout of the file '{}'", path);
+		fileReader = { };
+		return State::eDEVICE_CONNECTION_ERROR;
+	}
+
+	snapshot.formatString = makeFormatString(snapshot.format);
+	snapshot.channelsString = makeChannelsString(snapshot.format.channelLayout);
+
+	channelMixer.setLayout(snapshot.format.channelLayout);
+
+	fileStartTime = clock::now();
+	fileFramesPlayed = 0;
+
+	return State::eOK;
+}
+
 bool CaptureManager::capture() {
 	if (snapshot.state != State::eOK) {
 		return false;
 	}
 
+	if (fileReader.isValid()) {
+		return captureFile();
+	}
+
 	bool anyCaptured = false;
 	channelMixer.reset();
 
+	const index channelsCount = audioCaptureClient.getChannelsCount();
 	while (true) {
-		audioCaptureClient.readBuffer();
+		audioCaptureClient.readBuffer(
+			[&](index framesCount) {
+				return channelMixer.allocateChannelsData(channelsCount, framesCount);
+			}
+		);
 
 		const auto queryResult = audioCaptureClient.getLastResult();
 
 		if (queryResult == S_OK) {
 			anyCaptured = true;
-			channelMixer.saveChannelsData(audioCaptureClient.getBuffer());
 			continue;
 		}
 		if (queryResult == AUDCLNT_S_BUFFER_EMPTY) {
@@ -207,6 +256,51 @@ bool CaptureManager::capture() {
 	return anyCaptured;
 }
 
+bool CaptureManager::captureFile() {
+	const index sampleRate = snapshot.format.samplesPerSec;
+	const double elapsedSec = std::chrono::duration<double>{ clock::now() - fileStartTime }.count();
+	const index targetFramesPlayed = static_cast<index>(elapsedSec * double(sampleRate));
+
+	// if we were not called for a long time then just skip missed data
+	fileFramesPlayed = std::max(fileFramesPlayed, targetFramesPlayed - sampleRate);
+
+	const index framesToRead = targetFramesPlayed - fileFramesPlayed;
+	if (framesToRead <= 0 || fileReader.getFramesCount() == 0) {
+		return false;
+	}
+
+	channelMixer.reset();
+
+	index remainingFrames = framesToRead;
+	bool justRewound = false;
+	while (remainingFrames > 0) {
+		const index framesRead = fileReader.read(remainingFrames);
+		if (framesRead == 0) {
+			// reader shrinks frames count when data ends before its declared size,
+			// so a file that is truncated to nothing would be rewound forever
+			if (justRewound || fileReader.getFramesCount() == 0) {
+				logger.error(L"wave file '{}' doesn't contain any audio data", snapshot.id);
+				snapshot.state = State::eDEVICE_CONNECTION_ERROR;
+				return false;
+			}
+
+			// file is played in a loop
+			fileReader.rewind();
+			justRewound = true;
+			continue;
+		}
+
+		channelMixer.saveChannelsData(fileReader.getBuffer());
+		remainingFrames -= framesRead;
+		justRewound = false;
+	}
+	fileFramesPlayed += framesToRead;
+
+	channelMixer.createAuto();
+
+	return true;
+}
+
 void CaptureManager::tryToRecoverFromExclusive() {
 	const auto changes = sessionEventsWrapper.grabChanges();
 	switch (changes.disconnectionReason) {
@@ -272,6 +366,8 @@ utils::MediaDeviceWrapper CaptureManager::getDevice(const SourceDesc& desc) {
 		return enumeratorWrapper.getDefaultDevice(utils::MediaDeviceType::eOUTPUT);
 	case SourceDesc::Type::eID:
 		return enumeratorWrapper.getDeviceByID(desc.id);
+	case SourceDesc::Type::eFILE:
+		break;
 	}
 
 	return { };
@@ -291,6 +387,19 @@ string CaptureManager::makeFormatString(MyWaveFormat waveFormat) {
 	return string{ bp.getBufferView() };
 }
 
+string CaptureManager::makeChannelsString(const ChannelLayout& layout) {
+	string result;
+
+	auto channels = layout.ordered();
+	for (int i = 0; i < channels.size() - 1; ++i) {
+		result += ChannelUtils::getTechnicalName(channels[i]);
+		result += L',';
+	}
+	result += ChannelUtils::getTechnicalName(channels.back());
+
+	return result;
+}
+
 void CaptureManager::createExclusiveStreamListener() {
 	sessionEventsWrapper.destruct();
 
@@ -13,6 +13,8 @@
 #include "windows-wrappers/MediaDeviceWrapper.h"
 #include "RainmeterWrappers.h"
 #include "windows-wrappers/IAudioCaptureClientWrapper.h"
+#include "WaveFileReader.h"
+#include <chrono>
 #include <functional>
 
 #include "AudioSessionEventsWrapper.h"
@@ -28,8 +30,10 @@ namespace rxtd::audio_analyzer {
 				eDEFAULT_INPUT,
 				eDEFAULT_OUTPUT,
 				eID,
+				eFILE,
 			} type{ };
 
+			// device id or path to the file
 			string id;
 
 			friend bool operator==(const SourceDesc& lhs, const SourceDesc& rhs) {
@@ -64,6 +68,8 @@ namespace rxtd::audio_analyzer {
 		};
 
 	private:
+		using clock = std::chrono::steady_clock;
+
 		utils::Rainmeter::Logger logger;
 		index legacyNumber = 0;
 		index bufferSize100NsUnits{ };
@@ -75,6 +81,11 @@ namespace rxtd::audio_analyzer {
 		AudioSessionEventsWrapper sessionEventsWrapper;
 		ChannelMixer channelMixer;
 
+		// file is read in real time: it is assumed to start playing when it is opened
+		utils::WaveFileReader fileReader;
+		clock::time_point fileStartTime;
+		index fileFramesPlayed{ };
+
 		Snapshot snapshot;
 
 		index lastExclusiveProcessId = -1;
@@ -97,6 +108,9 @@ namespace rxtd::audio_analyzer {
 		[[nodiscard]]
 		State setSourceAndGetState(const SourceDesc& desc);
 
+		[[nodiscard]]
+		State openFile(const string& path);
+
 	public:
 		const Snapshot& getSnapshot() const {
 			return snapshot;
@@ -121,9 +135,14 @@ namespace rxtd::audio_analyzer {
 		[[nodiscard]]
 		utils::MediaDeviceWrapper getDevice(const SourceDesc& desc);
 
+		bool captureFile();
+
 		[[nodiscard]]
 		static string makeFormatString(MyWaveFormat waveFormat);
 
+		[[nodiscard]]
+		static string makeChannelsString(const ChannelLayout& layout);
+
 		void createExclusiveStreamListener();
 
 		std::vector<utils::GenericComWrapper<IAudioSessionControl>> getActiveSessions();
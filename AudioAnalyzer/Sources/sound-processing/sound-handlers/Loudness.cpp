@@ -8,11 +8,16 @@
  */
 
 #include "Loudness.h"
+#include <numeric>
 
 #include "MyMath.h"
 
 using namespace audio_analyzer;
 
+// EBU R 128 gating: -70 LUFS absolute, -10 LU relative
+static const double integratedAbsoluteGate = std::pow(10.0, (-70.0 + 0.691) * 0.1);
+static const double integratedRelativeGate = std::pow(10.0, -10.0 * 0.1);
+
 SoundHandler::ParseResult Loudness::parseParams(
 	const OptionMap& om, Logger& cl, const Rainmeter& rain,
 	index legacyNumber
@@ -20,6 +25,20 @@ SoundHandler::ParseResult Loudness::parseParams(
 	ParseResult result { true };
 	auto& params = result.params.clear<Params>();
 
+	if (const auto modeString = om.get(L"mode").asIString(L"custom");
+		modeString == L"custom") {
+		params.mode = Mode::eCUSTOM;
+	} else if (modeString == L"momentary") {
+		params.mode = Mode::eMOMENTARY;
+	} else if (modeString == L"shortTerm") {
+		params.mode = Mode::eSHORT_TERM;
+	} else if (modeString == L"integrated") {
+		params.mode = Mode::eINTEGRATED;
+	} else {
+		cl.warning(L"mode '{}' is not recognized, assume 'custom'", modeString);
+		params.mode = Mode::eCUSTOM;
+	}
+
 	auto transformLogger = cl.context(L"transform: ");
 	params.transformer = CVT::parse(om.get(L"transform").asString(), transformLogger);
 
@@ -30,7 +49,7 @@ SoundHandler::ParseResult Loudness::parseParams(
 	params.updatesPerSecond = std::clamp(params.updatesPerSecond, 0.01, 60.0);
 
 	params.timeWindowMs = om.get(L"timeWindow").asFloat(1000.0);
-	params.timeWindowMs = std::clamp(params.timeWindowMs, 0.01, 10000.0);
+	params.timeWindowMs = std::clamp(params.timeWindowMs, 0.01, 600000.0);
 
 	params.gatingDb = om.get(L"gatingDb").asFloat(-20.0);
 	params.gatingDb = std::clamp(params.gatingDb, -70.0, 0.0);
@@ -43,21 +62,53 @@ SoundHandler::ParseResult Loudness::parseParams(
 SoundHandler::ConfigurationResult Loudness::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData& externalData) {
 	params = _params.cast<Params>();
 
-	blocksCount = index(params.timeWindowMs / 1000.0 * params.updatesPerSecond);
-	blocksCount = std::max<index>(blocksCount, 1);
+	double updatesPerSecond = params.updatesPerSecond;
+	double timeWindowMs = params.timeWindowMs;
+	switch (params.mode) {
+	case Mode::eCUSTOM: break;
+	case Mode::eMOMENTARY:
+		timeWindowMs = 400.0;
+		break;
+	case Mode::eSHORT_TERM:
+		timeWindowMs = 3000.0;
+		break;
+	case Mode::eINTEGRATED:
+		// gating blocks of 400 ms with 75% overlap
+		updatesPerSecond = 10.0;
+		timeWindowMs = 400.0;
+		break;
+	}
+
+	if (params.mode == Mode::eMOMENTARY || params.mode == Mode::eSHORT_TERM) {
+		// window length is defined by the mode, so blocks are adjusted to cover it exactly
+		blocksCount = std::max<index>(std::lround(timeWindowMs / 1000.0 * updatesPerSecond), 1);
+		updatesPerSecond = blocksCount * 1000.0 / timeWindowMs;
+	} else {
+		blocksCount = index(timeWindowMs / 1000.0 * updatesPerSecond);
+		blocksCount = std::max<index>(blocksCount, 1);
+	}
 
 	auto& config = getConfiguration();
 	const index sampleRate = config.sampleRate;
 
-	blockSize = index(sampleRate / params.updatesPerSecond);
+	blockSize = index(sampleRate / updatesPerSecond);
 	blockNormalizer = 1.0 / blockSize;
 	blockCounter = 0;
 
 	blocks.resize(blocksCount);
 	std::fill(blocks.begin(), blocks.end(), 0.0);
+	nextBlockIndex = 0;
+	filledBlocksCount = 0;
 	prevValue = 0.0;
 
-	gatingValueCoefficient = utils::MyMath::db2amplitude(params.gatingDb) * blockSize;
+	useHistogram = params.mode == Mode::eINTEGRATED || blocksCount > maxScannedBlocksCount;
+	windowsSinceHistogramRebuild = 0;
+	histogram.reset();
+	if (params.mode != Mode::eINTEGRATED && useHistogram) {
+		rebuildHistogram();
+	}
+
+	gatingValueCoefficient = utils::MyMath::db2amplitude(params.gatingDb);
 
 	minBlocksCount = index(blocksCount * (1.0 - params.gatingLimit));
 
@@ -77,30 +128,103 @@ void Loudness::vProcess(ProcessContext context, ExternalData& externalData) {
 }
 
 void Loudness::pushMicroBlock(double value) {
-	blocks[nextBlockIndex] = value;
+	const double energy = value * blockNormalizer;
+
+	if (params.mode == Mode::eINTEGRATED) {
+		pushIntegratedBlock(energy);
+		return;
+	}
+
+	if (useHistogram) {
+		histogram.remove(blocks[nextBlockIndex]);
+		histogram.add(energy);
+	}
+	blocks[nextBlockIndex] = energy;
 	nextBlockIndex++;
 	if (nextBlockIndex >= blocksCount) {
 		nextBlockIndex = 0;
+
+		if (useHistogram) {
+			windowsSinceHistogramRebuild++;
+			if (windowsSinceHistogramRebuild >= windowsPerHistogramRebuild) {
+				windowsSinceHistogramRebuild = 0;
+				rebuildHistogram();
+			}
+		}
 	}
 
-	const double gatingValue = prevValue * gatingValueCoefficient;
+	// momentary and short-term loudness are not gated
+	const double gatingValue = params.mode == Mode::eCUSTOM ? prevValue * gatingValueCoefficient : 0.0;
+	const auto gated = getGatedBlocks(gatingValue);
 
 	double newValue = 0.0;
-	index counter = 0;
+	if (gated.count != 0) {
+		newValue = gated.sum / std::max(gated.count, minBlocksCount);
+	}
+
+	pushNextValue(newValue);
+}
+
+void Loudness::rebuildHistogram() {
+	histogram.reset();
 	for (const auto blockEnergy : blocks) {
-		if (params.ignoreGatingForSilence && blockEnergy == 0.0
-			|| blockEnergy >= gatingValue) {
-			newValue += blockEnergy;
-			counter++;
+		histogram.add(blockEnergy);
+	}
+}
+
+audio_utils::EnergyHistogram::Values Loudness::getGatedBlocks(double gatingValue) const {
+	if (!useHistogram) {
+		audio_utils::EnergyHistogram::Values result;
+		for (const auto blockEnergy : blocks) {
+			if ((params.ignoreGatingForSilence && blockEnergy == 0.0)
+				|| blockEnergy >= gatingValue) {
+				result.sum += blockEnergy;
+				result.count++;
+			}
 		}
+		return result;
 	}
-	if (counter != 0) {
-		counter = std::max(counter, minBlocksCount);
-		newValue /= counter;
-		newValue *= blockNormalizer;
+
+	if (gatingValue <= 0.0) {
+		// everything passes the gate
+		return histogram.getAll();
 	}
 
-	pushNextValue(newValue);
+	auto result = histogram.getAbove(gatingValue);
+	if (params.ignoreGatingForSilence) {
+		result.count += histogram.getZeroCount();
+	}
+	return result;
+}
+
+void Loudness::pushIntegratedBlock(double energy) {
+	blocks[nextBlockIndex] = energy;
+	nextBlockIndex++;
+	if (nextBlockIndex >= blocksCount) {
+		nextBlockIndex = 0;
+	}
+
+	// first gating block is only complete when all its sub-blocks are filled
+	if (filledBlocksCount < blocksCount) {
+		filledBlocksCount++;
+		if (filledBlocksCount < blocksCount) {
+			pushNextValue(prevValue);
+			return;
+		}
+	}
+
+	const double blockEnergy = std::accumulate(blocks.begin(), blocks.end(), 0.0) / blocksCount;
+	histogram.add(blockEnergy);
+
+	const auto absoluteGated = histogram.getAbove(integratedAbsoluteGate);
+	if (absoluteGated.count == 0) {
+		pushNextValue(0.0);
+		return;
+	}
+
+	const double relativeGate = absoluteGated.sum / absoluteGated.count * integratedRelativeGate;
+	const auto gated = histogram.getAbove(std::max(relativeGate, integratedAbsoluteGate));
+	pushNextValue(gated.count == 0 ? 0.0 : gated.sum / gated.count);
 }
 
 void Loudness::pushNextValue(double value) {
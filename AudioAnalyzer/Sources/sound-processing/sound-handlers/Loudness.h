@@ -10,12 +10,21 @@
 #pragma once
 #include "SoundHandler.h"
 #include "../../audio-utils/CustomizableValueTransformer.h"
+#include "../../audio-utils/EnergyHistogram.h"
 
 namespace rxtd::audio_analyzer {
 	class Loudness : public SoundHandler {
 		using CVT = audio_utils::CustomizableValueTransformer;
 
+		enum class Mode {
+			eCUSTOM,
+			eMOMENTARY,
+			eSHORT_TERM,
+			eINTEGRATED,
+		};
+
 		struct Params {
+			Mode mode{ };
 			CVT transformer{ };
 			double gatingLimit{ };
 			double updatesPerSecond{ };
@@ -25,7 +34,8 @@ namespace rxtd::audio_analyzer {
 
 			// autogenerated
 			friend bool operator==(const Params& lhs, const Params& rhs) {
-				return lhs.transformer == rhs.transformer
+				return lhs.mode == rhs.mode
+					&& lhs.transformer == rhs.transformer
 					&& lhs.gatingLimit == rhs.gatingLimit
 					&& lhs.updatesPerSecond == rhs.updatesPerSecond
 					&& lhs.timeWindowMs == rhs.timeWindowMs
@@ -38,6 +48,12 @@ namespace rxtd::audio_analyzer {
 			}
 		};
 
+		// Scanning a few blocks directly is cheaper than updating histogram,
+		// and it doesn't round gating threshold
+		static constexpr index maxScannedBlocksCount = 64;
+		// histogram accumulates rounding errors, so it is rebuilt once per this many windows
+		static constexpr index windowsPerHistogramRebuild = 16;
+
 		Params params{ };
 
 		index blocksCount{ };
@@ -46,8 +62,15 @@ namespace rxtd::audio_analyzer {
 		index blockCounter{ };
 
 		double blockIntermediate{ };
+		// normalized energies of last #blocksCount blocks
 		std::vector<double> blocks;
 		index nextBlockIndex{ };
+		index filledBlocksCount{ };
+		// in custom, momentary and short-term modes contains values from #blocks when there are many of them,
+		// in integrated mode contains all gating blocks since configuration
+		audio_utils::EnergyHistogram histogram;
+		bool useHistogram{ };
+		index windowsSinceHistogramRebuild{ };
 
 		double prevValue{ };
 		double gatingValueCoefficient{ };
@@ -74,6 +97,13 @@ namespace rxtd::audio_analyzer {
 		void pushMicroBlock(double value);
 
 	private:
+		void rebuildHistogram();
+
+		// sum and count of blocks that pass the gate
+		[[nodiscard]]
+		audio_utils::EnergyHistogram::Values getGatedBlocks(double gatingValue) const;
+
+		void pushIntegratedBlock(double energy);
 		void pushNextValue(double value);
 	};
 }
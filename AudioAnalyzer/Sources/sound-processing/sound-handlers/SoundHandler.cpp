@@ -19,7 +19,7 @@ bool SoundHandler::patch(
 	Snapshot& snapshot
 ) {
 	if (sources.size() > 1) {
-		throw std::exception{ "no support for multiple sources yet" }; // todo
+		throw std::runtime_error{ "no support for multiple sources yet" }; // todo
 	}
 
 	Configuration newConfig;
@@ -32,6 +32,7 @@
 #include "BufferPrinter.h"
 #include "RainmeterWrappers.h"
 #include "Vector2D.h"
+#include "image-utils/ImageWriteQueue.h"
 #include "option-parser/OptionMap.h"
 
 namespace rxtd::audio_analyzer {
@@ -50,7 +51,7 @@ namespace rxtd::audio_analyzer {
 		using OptionMap = utils::OptionMap;
 		using Rainmeter = utils::Rainmeter;
 		using Logger = utils::Rainmeter::Logger;
-		using clock = std::chrono::high_resolution_clock;
+		using clock = std::chrono::steady_clock;
 		static_assert(clock::is_steady);
 
 		struct DataSize {
@@ -76,6 +77,8 @@ namespace rxtd::audio_analyzer {
 			index legacyNumber{ };
 			sview channelName{ };
 			sview filePrefix{ };
+			// nullptr when images are written in the calling thread
+			utils::ImageWriteQueue* imageWriteQueue{ };
 		};
 
 		struct ProcessContext {
@@ -110,10 +113,13 @@ namespace rxtd::audio_analyzer {
 
 		class ExternalData {
 			std::any erasedData;
+			// handler that is shared with another processing only refers to data of the original handler
+			const ExternalData* sharedData = nullptr;
 
 		public:
 			template <typename T>
 			T& clear() {
+				sharedData = nullptr;
 				erasedData = T{ };
 				return cast<T>();
 			}
@@ -125,7 +131,15 @@ namespace rxtd::audio_analyzer {
 
 			template <typename T>
 			const T& cast() const {
-				return *std::any_cast<T>(&erasedData);
+				const auto& data = sharedData != nullptr ? sharedData->erasedData : erasedData;
+				return *std::any_cast<T>(&data);
+			}
+
+			// makes const #cast read data of #other without copying it
+			// #other must stay at the same address while this object is used
+			void share(const ExternalData& other) {
+				erasedData.reset();
+				sharedData = other.sharedData != nullptr ? other.sharedData : &other;
 			}
 
 			// prevent automatic type conversions
@@ -168,9 +182,22 @@ namespace rxtd::audio_analyzer {
 			}
 		};
 
+		// timings of #process calls, filled by ProcessingManager
+		struct PerformanceInfo {
+			double lastMs{ };
+			// exponentially weighted moving average
+			double averageMs{ };
+			// over last few hundreds calls
+			double p99Ms{ };
+			// count of calls during which kill time was reached
+			index killsCount{ };
+			index callsCount{ };
+		};
+
 		struct Snapshot {
 			utils::Vector2D<float> values;
 			ExternalData handlerSpecificData;
+			PerformanceInfo performance;
 		};
 
 	protected:
@@ -331,7 +358,7 @@ namespace rxtd::audio_analyzer {
 					return methodPtr(dataWrapper.cast<DataStructType>(), prop, bp, context);
 				};
 			} else {
-				static_assert(false, L"wrapExternalMethod: unsupported method");
+				static_assert(sizeof(DataStructType) == 0, "wrapExternalMethod: unsupported method");
 			}
 		}
 
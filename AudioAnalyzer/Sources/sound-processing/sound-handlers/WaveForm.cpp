@@ -11,6 +11,7 @@
 #include <filesystem>
 
 #include "MyMath.h"
+#include "windows-wrappers/FileWrapper.h"
 
 using namespace std::string_literals;
 using utils::Color;
@@ -52,6 +53,16 @@ SoundHandler::ParseResult WaveForm::parseParams(
 		rain.replaceVariables(L"[#CURRENTPATH]") % own()
 	);
 
+	if (const auto formatString = om.get(L"imageFormat").asIString(L"bmp");
+		formatString == L"bmp") {
+		params.imageFormat = utils::ImageFormat::BMP;
+	} else if (formatString == L"png") {
+		params.imageFormat = utils::ImageFormat::PNG;
+	} else {
+		cl.warning(L"imageFormat '{}' is not recognized, assume 'bmp'", formatString);
+		params.imageFormat = utils::ImageFormat::BMP;
+	}
+
 	params.colors.background = Color::parse(om.get(L"backgroundColor").asString(), { 0, 0, 0 }).toIntColor();
 	params.colors.wave = Color::parse(om.get(L"waveColor").asString(), { 1, 1, 1 }).toIntColor();
 	params.colors.line = Color::parse(om.get(L"lineColor").asString(), { 0.5, 0.5, 0.5, 0.5 }).toIntColor();
@@ -130,6 +141,7 @@ WaveForm::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData& e
 	if (config.legacyNumber < 104) {
 		snapshot.prefix += L"wave-";
 	}
+	snapshot.imageFormat = params.imageFormat;
 
 	snapshot.blockSize = blockSize;
 
@@ -137,6 +149,8 @@ WaveForm::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData& e
 	snapshot.pixels.setBufferSize(params.width);
 
 	snapshot.pixels.copyWithResize(drawer.getResultBuffer());
+	imageVersion++;
+	snapshot.pixelsVersion = imageVersion;
 
 	snapshot.writeNeeded = true;
 	snapshot.empty = false;
@@ -177,12 +191,17 @@ void WaveForm::vProcess(ProcessContext context, ExternalData& externalData) {
 
 	if (anyChanges) {
 		drawer.inflate();
+		imageVersion++;
+	}
 
-		auto& snapshot = externalData.cast<Snapshot>();
+	// snapshot may hold older image even if nothing has changed since last call
+	auto& snapshot = externalData.cast<Snapshot>();
+	if (snapshot.pixelsVersion != imageVersion) {
 		snapshot.writeNeeded = true;
 		snapshot.empty = drawer.isEmpty();
 
 		snapshot.pixels.copyWithResize(drawer.getResultBuffer());
+		snapshot.pixelsVersion = imageVersion;
 	}
 }
 
@@ -194,9 +213,12 @@ void WaveForm::staticFinisher(const Snapshot& snapshot, const ExternCallContext&
 
 	snapshot.filenameBuffer = snapshot.prefix;
 	snapshot.filenameBuffer += context.legacyNumber < 104 ? context.channelName : context.filePrefix;
-	snapshot.filenameBuffer += L".bmp";
+	snapshot.filenameBuffer += utils::ImageFormatUtils::getExtension(snapshot.imageFormat);
 
-	snapshot.writerHelper.write(snapshot.pixels, snapshot.empty, snapshot.filenameBuffer);
+	snapshot.writerHelper.write(
+		snapshot.pixels, snapshot.empty,
+		snapshot.filenameBuffer, snapshot.imageFormat, context.imageWriteQueue
+	);
 	writeNeeded = false;
 }
 
@@ -209,7 +231,7 @@ bool WaveForm::getProp(
 	if (prop == L"file") {
 		snapshot.filenameBuffer = snapshot.prefix;
 		snapshot.filenameBuffer += context.legacyNumber < 104 ? context.channelName : context.filePrefix;
-		snapshot.filenameBuffer += L".bmp";
+		snapshot.filenameBuffer += utils::ImageFormatUtils::getExtension(snapshot.imageFormat);
 
 		printer.print(snapshot.filenameBuffer);
 		return true;
@@ -219,5 +241,8 @@ bool WaveForm::getProp(
 		return true;
 	}
 
-	return false;
+	snapshot.filenameBuffer = snapshot.prefix;
+	snapshot.filenameBuffer += context.legacyNumber < 104 ? context.channelName : context.filePrefix;
+	snapshot.filenameBuffer += utils::ImageFormatUtils::getExtension(snapshot.imageFormat);
+	return utils::ImageWriteHelper::getQueueProp(prop, snapshot.filenameBuffer, context.imageWriteQueue, printer);
 }
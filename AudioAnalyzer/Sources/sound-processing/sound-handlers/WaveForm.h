@@ -25,6 +25,7 @@ namespace rxtd::audio_analyzer {
 			index width{ };
 			index height{ };
 			string folder;
+			utils::ImageFormat imageFormat{ };
 			Colors colors{ };
 			LDP lineDrawingPolicy{ };
 			index lineThickness{ };
@@ -41,6 +42,7 @@ namespace rxtd::audio_analyzer {
 					&& lhs.width == rhs.width
 					&& lhs.height == rhs.height
 					&& lhs.folder == rhs.folder
+					&& lhs.imageFormat == rhs.imageFormat
 					&& lhs.colors == rhs.colors
 					&& lhs.lineDrawingPolicy == rhs.lineDrawingPolicy
 					&& lhs.lineThickness == rhs.lineThickness
@@ -61,9 +63,12 @@ namespace rxtd::audio_analyzer {
 			index blockSize{ };
 
 			string prefix;
+			utils::ImageFormat imageFormat{ };
 
 			utils::Vector2D<utils::IntColor> pixels;
 			bool empty{ };
+			// snapshots are reused in turn, so each of them may hold different version of the image
+			index pixelsVersion{ };
 
 			mutable utils::ImageWriteHelper writerHelper{ };
 			mutable bool writeNeeded{ };
@@ -79,6 +84,7 @@ namespace rxtd::audio_analyzer {
 		double minDistinguishableValue{ };
 
 		utils::WaveFormDrawer drawer{ };
+		index imageVersion{ };
 
 	public:
 		[[nodiscard]]
@@ -85,6 +85,17 @@ BandCascadeTransformer::vConfigure(const ParamsContainer& _params, Logger& cl, E
 	snapshot.clear();
 	snapshot.resize(dataSize.layersCount);
 
+	// Decimation delays content of deeper cascades.
+	// It can't be fully undone without delaying shallow cascades,
+	// but chunks of deeper cascades can be taken earlier, up to one chunk period,
+	// so that they at least don't lag even further behind
+	const auto& eqWS = dataSize.eqWaveSizes;
+	const index firstLayerLatency = resamplerPtr->getLayerLatency(0);
+	for (index i = 0; i < dataSize.layersCount; i++) {
+		const index extraLatency = resamplerPtr->getLayerLatency(i) - firstLayerLatency;
+		snapshot[i].offset = -std::min(extraLatency, eqWS[i]);
+	}
+
 	return { dataSize.valuesCount, { config.sourcePtr->getDataSize().eqWaveSizes[0] } };
 }
 
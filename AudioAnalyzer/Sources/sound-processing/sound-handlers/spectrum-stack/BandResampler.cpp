@@ -8,6 +8,7 @@
  */
 
 #include "BandResampler.h"
+#include <emmintrin.h>
 
 #include "LinearInterpolator.h"
 #include "../../../audio-utils/CubicInterpolationHelper.h"
@@ -17,6 +18,26 @@ using namespace std::string_literals;
 
 using namespace audio_analyzer;
 
+namespace {
+	float sumRange(const float* values, index count) {
+		__m128 sum4 = _mm_setzero_ps();
+		index i = 0;
+		for (; i + 4 <= count; i += 4) {
+			sum4 = _mm_add_ps(sum4, _mm_loadu_ps(values + i));
+		}
+
+		// horizontal sum
+		sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+		sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 0b01));
+		float sum = _mm_cvtss_f32(sum4);
+
+		for (; i < count; i++) {
+			sum += values[i];
+		}
+		return sum;
+	}
+}
+
 SoundHandler::ParseResult BandResampler::parseParams(
 	const OptionMap& om, Logger& cl, const Rainmeter& rain,
 	index legacyNumber
@@ -258,6 +279,7 @@ void BandResampler::vProcess(ProcessContext context, ExternalData& externalData)
 
 	for (index cascadeIndex = startCascade; cascadeIndex < endCascade; ++cascadeIndex) {
 		const index localCascadeIndex = cascadeIndex - startCascade;
+		auto& sampling = cascadeSamplings[localCascadeIndex];
 
 		for (auto chunk : source.getChunks(cascadeIndex)) {
 			auto dest = pushLayer(localCascadeIndex);
@@ -269,7 +291,11 @@ void BandResampler::vProcess(ProcessContext context, ExternalData& externalData)
 				continue;
 			}
 
-			sampleCascade(chunk, dest, binWidth);
+			if (chunk.size() != sampling.binsCount) {
+				// should not happen, because fft size can't change without reconfiguration
+				computeCascadeSampling(sampling, chunk.size(), binWidth);
+			}
+			sampleCascade(chunk, dest, sampling);
 
 			if (params.legacy_proportionalValues) {
 				for (index band = 0; band < bandsCount; ++band) {
@@ -282,42 +308,25 @@ void BandResampler::vProcess(ProcessContext context, ExternalData& externalData)
 	}
 }
 
-void BandResampler::sampleCascade(array_view<float> source, array_span<float> dest, double binWidth) {
-	const index fftBinsCount = source.size();
+void BandResampler::sampleCascade(
+	array_view<float> source, array_span<float> dest,
+	const CascadeSampling& sampling
+) const {
+	for (index band = 0; band < bandsCount; band++) {
+		const auto range = sampling.bandRanges[band];
+		dest[band] = sumRange(source.data() + range.begin, range.count) * range.weight;
+	}
 
-	utils::LinearInterpolator lowerBinBoundInter;
-	lowerBinBoundInter.setParams(
-		-binWidth * 0.5,
-		(fftBinsCount - 0.5) * binWidth,
-		double(0),
-		double(fftBinsCount - 1)
-	);
+	if (sampling.cubicPoints.empty()) {
+		return;
+	}
 
 	audio_utils::CubicInterpolationHelper cih;
 	cih.setSource(source);
 
-	for (index band = 0; band < bandsCount; band++) {
-		const double bandMinFreq = params.bandFreqs[band];
-		const double bandMaxFreq = params.bandFreqs[band + 1];
-
-		if (params.useCubicResampling && bandMaxFreq - bandMinFreq < binWidth) {
-			const double interpolatedCoordinate = lowerBinBoundInter.toValue((bandMinFreq + bandMaxFreq) * 0.5);
-			const double value = cih.getValueFor(interpolatedCoordinate);
-			dest[band] = float(std::max(value, 0.0));
-		} else {
-			const index minBin = index(std::floor(lowerBinBoundInter.toValue(bandMinFreq)));
-			if (minBin >= fftBinsCount) {
-				break;
-			}
-			const index maxBin = std::min(index(std::floor(lowerBinBoundInter.toValue(bandMaxFreq))), fftBinsCount - 1);
-
-			float value = 0.0;
-			for (index bin = minBin; bin <= maxBin; ++bin) {
-				value += source[bin];
-			}
-			const float binsCount = (1.0f + maxBin - minBin);
-			dest[band] = value / binsCount;
-		}
+	for (const auto point : sampling.cubicPoints) {
+		const double value = cih.getValueAt(point.interval, point.offset);
+		dest[point.band] = float(std::max(value, 0.0));
 	}
 }
 
@@ -326,12 +335,67 @@ void BandResampler::computeWeights(index fftSize) {
 	const auto fftBinsCount = fftSize / 2;
 	double binWidth = static_cast<double>(config.sampleRate) / (fftSize * std::pow(2, startCascade));
 
+	cascadeSamplings.resize(layerWeights.getBuffersCount());
+
 	for (index i = 0; i < layerWeights.getBuffersCount(); ++i) {
 		computeCascadeWeights(layerWeights[i], fftBinsCount, binWidth);
+		computeCascadeSampling(cascadeSamplings[i], fftBinsCount, binWidth);
 		binWidth *= 0.5;
 	}
 }
 
+void BandResampler::computeCascadeSampling(CascadeSampling& result, index fftBinsCount, double binWidth) const {
+	result.binsCount = fftBinsCount;
+	result.bandRanges.clear();
+	result.bandRanges.resize(bandsCount);
+	result.cubicPoints.clear();
+
+	const utils::LinearInterpolator lowerBinBoundInter{
+		-binWidth * 0.5,
+		(fftBinsCount - 0.5) * binWidth,
+		double(0),
+		double(fftBinsCount - 1)
+	};
+
+	for (index band = 0; band < bandsCount; band++) {
+		const double bandMinFreq = params.bandFreqs[band];
+		const double bandMaxFreq = params.bandFreqs[band + 1];
+
+		if (params.useCubicResampling && bandMaxFreq - bandMinFreq < binWidth && fftBinsCount >= 2) {
+			const double interpolatedCoordinate = lowerBinBoundInter.toValue((bandMinFreq + bandMaxFreq) * 0.5);
+			const double floor = std::floor(interpolatedCoordinate);
+
+			// same edge cases as in CubicInterpolationHelper#getValueFor
+			CascadeSampling::CubicPoint point;
+			point.band = band;
+			if (floor < 0.0) {
+				point.interval = 0;
+				point.offset = 0.0f;
+			} else if (index(floor) + 1 >= fftBinsCount) {
+				point.interval = fftBinsCount - 2;
+				point.offset = 1.0f;
+			} else {
+				point.interval = index(floor);
+				point.offset = float(interpolatedCoordinate - floor);
+			}
+			result.cubicPoints.push_back(point);
+			continue;
+		}
+
+		const index minBin = index(std::floor(lowerBinBoundInter.toValue(bandMinFreq)));
+		if (minBin >= fftBinsCount) {
+			// all following bands are also out of range and must stay zero
+			break;
+		}
+		const index maxBin = std::min(index(std::floor(lowerBinBoundInter.toValue(bandMaxFreq))), fftBinsCount - 1);
+
+		auto& range = result.bandRanges[band];
+		range.begin = minBin;
+		range.count = maxBin - minBin + 1;
+		range.weight = 1.0f / float(range.count);
+	}
+}
+
 void BandResampler::computeCascadeWeights(array_span<float> result, index fftBinsCount, double binWidth) {
 	const double binWidthInverse = 1.0 / binWidth;
 
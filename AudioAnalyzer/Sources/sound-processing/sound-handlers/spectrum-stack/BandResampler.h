@@ -44,9 +44,33 @@ namespace rxtd::audio_analyzer {
 
 		FftAnalyzer* fftSource = nullptr;
 
+		// Precomputed mapping from fft bins to bands of one cascade.
+		// Bands are stored as rows of a sparse matrix:
+		// each band is a weighted sum of a contiguous range of bins,
+		// except for narrow bands with cubic resampling,
+		// which are interpolated at precomputed points instead.
+		struct CascadeSampling {
+			struct BinRange {
+				index begin{ };
+				index count{ };
+				float weight{ };
+			};
+
+			struct CubicPoint {
+				index band{ };
+				index interval{ };
+				float offset{ };
+			};
+
+			index binsCount{ };
+			std::vector<BinRange> bandRanges;
+			std::vector<CubicPoint> cubicPoints;
+		};
+
 		std::vector<float> legacy_bandFreqMultipliers{ };
 		utils::Vector2D<float> layerWeights;
 		utils::Vector2D<float> bandWeights;
+		std::vector<CascadeSampling> cascadeSamplings;
 
 		index startCascade = 0;
 		index endCascade = 0;
@@ -100,15 +124,22 @@ namespace rxtd::audio_analyzer {
 			return bandWeights[band];
 		}
 
+		// delay of decimation before specified layer, in samples of original sample rate
+		[[nodiscard]]
+		index getLayerLatency(index layer) const {
+			return fftSource->getCascadeLatency(startCascade + layer);
+		}
+
 		BandResampler* getResampler() override {
 			return this;
 		}
 
 	private:
-		void sampleCascade(array_view<float> source, array_span<float> dest, double binWidth);
+		void sampleCascade(array_view<float> source, array_span<float> dest, const CascadeSampling& sampling) const;
 
 		// depends on fft size and sample rate
 		void computeWeights(index fftSize);
+		void computeCascadeSampling(CascadeSampling& result, index fftBinsCount, double binWidth) const;
 		void computeCascadeWeights(array_span<float> result, index fftBinsCount, double binWidth);
 
 		void legacy_generateBandMultipliers();
@@ -9,6 +9,7 @@
 
 #include <random>
 #include "../../../audio-utils/RandomGenerator.h"
+#include "../../../audio-utils/kiss_fft-lib/KissFft.hh"
 
 #include "FftAnalyzer.h"
 
@@ -94,6 +95,16 @@ SoundHandler::ParseResult FftAnalyzer::parseParams(
 		params.cascadesCount = 20;
 	}
 
+	if (const auto decimator = om.get(L"cascadeDecimator").asIString(L"butterworth");
+		decimator == L"butterworth") {
+		params.cascadeDecimator = audio_utils::FftCascade::Decimator::BUTTERWORTH;
+	} else if (decimator == L"halfband") {
+		params.cascadeDecimator = audio_utils::FftCascade::Decimator::HALFBAND;
+	} else {
+		cl.warning(L"cascadeDecimator '{}' is not recognized, assume 'butterworth'", decimator);
+		params.cascadeDecimator = audio_utils::FftCascade::Decimator::BUTTERWORTH;
+	}
+
 	params.randomTest = std::abs(om.get(L"testRandom").asFloat(0.0));
 	params.randomDuration = std::abs(om.get(L"randomDuration").asFloat(1000.0)) * 0.001;
 
@@ -108,6 +119,8 @@ SoundHandler::ParseResult FftAnalyzer::parseParams(
 	params.wcfDescription = om.get(L"windowFunction").asString(L"hann");
 	params.wcf = audio_utils::WindowFunctionHelper::parse(params.wcfDescription, cl);
 
+	params.squared = om.get(L"squared").asBool(false);
+
 	result.externalMethods.getProp = wrapExternalMethod<Snapshot, &getProp>();
 	return result;
 }
@@ -146,7 +159,10 @@ FftAnalyzer::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 
 	fftSize = std::max<index>(fftSize, minFftSize);
 
-	fft.setParams(fftSize, !params.legacyAmplification, params.wcf(fftSize));
+	fft.setParams(
+		fftSize, !params.legacyAmplification,
+		audio_utils::WindowFunctionHelper::getShared(params.wcfDescription, fftSize, params.wcf)
+	);
 
 	inputStride = static_cast<index>(fftSize * (1 - params.overlap));
 	inputStride = std::clamp<index>(inputStride, minFftSize, fftSize);
@@ -163,6 +179,8 @@ FftAnalyzer::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 	cascadeParams.legacy_decayTime = params.legacy_decayTime;
 	cascadeParams.inputStride = inputStride;
 	cascadeParams.legacy_correctZero = params.legacy_correctZero;
+	cascadeParams.squared = params.squared;
+	cascadeParams.decimator = params.cascadeDecimator;
 	cascadeParams.callback = [this](array_view<float> result, index cascade) {
 		pushLayer(cascade).copyFrom(result);
 	};
@@ -204,6 +222,16 @@ void FftAnalyzer::vProcess(ProcessContext context, ExternalData& externalData) {
 	}
 }
 
+index FftAnalyzer::getCascadeLatency(index cascade) const {
+	index result = 0;
+	index sampleSize = 1;
+	for (index i = 1; i <= cascade && i < index(cascades.size()); i++) {
+		result += cascades[i].getLatency() * sampleSize;
+		sampleSize *= 2;
+	}
+	return result;
+}
+
 bool FftAnalyzer::getProp(
 	const Snapshot& snapshot,
 	isview prop,
@@ -37,10 +37,12 @@ namespace rxtd::audio_analyzer {
 			double overlap{ };
 
 			index cascadesCount{ };
+			audio_utils::FftCascade::Decimator cascadeDecimator{ };
 
 			double randomTest{ };
 			double randomDuration{ };
 			bool legacyAmplification{ };
+			bool squared{ };
 
 			string wcfDescription{ };
 			WCF wcf{ };
@@ -54,9 +56,11 @@ namespace rxtd::audio_analyzer {
 					&& lhs.binWidth == rhs.binWidth
 					&& lhs.overlap == rhs.overlap
 					&& lhs.cascadesCount == rhs.cascadesCount
+					&& lhs.cascadeDecimator == rhs.cascadeDecimator
 					&& lhs.randomTest == rhs.randomTest
 					&& lhs.randomDuration == rhs.randomDuration
 					&& lhs.legacyAmplification == rhs.legacyAmplification
+					&& lhs.squared == rhs.squared
 					&& lhs.wcfDescription == rhs.wcfDescription;
 			}
 
@@ -108,6 +112,10 @@ namespace rxtd::audio_analyzer {
 			return fftSize;
 		}
 
+		// total delay introduced by decimation before specified cascade, in samples of original sample rate
+		[[nodiscard]]
+		index getCascadeLatency(index cascade) const;
+
 		void vProcess(ProcessContext context, ExternalData& externalData) override;
 
 	private:
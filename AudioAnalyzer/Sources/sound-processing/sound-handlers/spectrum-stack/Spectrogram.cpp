@@ -9,6 +9,7 @@
 
 #include "Spectrogram.h"
 #include <filesystem>
+#include <emmintrin.h>
 
 #include "windows-wrappers/FileWrapper.h"
 #include "option-parser/OptionList.h"
@@ -55,6 +56,16 @@ SoundHandler::ParseResult Spectrogram::parseParams(
 		rain.replaceVariables(L"[#CURRENTPATH]") % own()
 	);
 
+	if (const auto formatString = om.get(L"imageFormat").asIString(L"bmp");
+		formatString == L"bmp") {
+		params.imageFormat = utils::ImageFormat::BMP;
+	} else if (formatString == L"png") {
+		params.imageFormat = utils::ImageFormat::PNG;
+	} else {
+		cl.warning(L"imageFormat '{}' is not recognized, assume 'bmp'", formatString);
+		params.imageFormat = utils::ImageFormat::BMP;
+	}
+
 	using MixMode = Color::Mode;
 	if (auto mixMode = om.get(L"mixMode").asIString(L"srgb");
 		mixMode == L"srgb") {
@@ -151,7 +162,10 @@ Spectrogram::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 	const auto backgroundIntColor = params.colors[0].color.toIntColor();
 	image.setParams(width, height, backgroundIntColor, params.stationary);
 
-	fadeHelper.setParams(backgroundIntColor, params.borderSize, params.borderColor.toIntColor(), params.fading);
+	fadeHelper.setParams(
+		backgroundIntColor, params.borderSize, params.borderColor.toIntColor(),
+		params.fading, params.stationary
+	);
 
 	if (params.fading != 0.0) {
 		fadeHelper.setPastLastStripIndex(image.getPastLastStripIndex());
@@ -180,10 +194,13 @@ Spectrogram::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 	if (config.legacyNumber < 104) {
 		snapshot.prefix += L"spectrogram-";
 	}
+	snapshot.imageFormat = params.imageFormat;
 
 	snapshot.blockSize = blockSize;
 
 	snapshot.pixels.copyWithResize(params.fading != 0.0 ? fadeHelper.getResultBuffer() : image.getPixels());
+	imageVersion++;
+	snapshot.pixelsVersion = imageVersion;
 
 	snapshot.writeNeeded = true;
 	snapshot.empty = false;
@@ -209,14 +226,20 @@ void Spectrogram::vProcess(ProcessContext context, ExternalData& externalData) {
 		}
 
 		ism.next();
-		imageHasChanged = true;
 
+		// image that is already silent doesn't take new silent strips, and doesn't need to be redrawn
+		bool stripWasPushed = true;
 		if (minMaxCounter.isBelowThreshold(params.silenceThreshold)) {
-			image.pushEmptyStrip(params.colors[0].color.toIntColor());
+			stripWasPushed = image.pushEmptyStrip(params.colors[0].color.toIntColor());
 		} else {
 			image.pushStrip(ism.getBuffer());
 		}
 		minMaxCounter.reset();
+
+		if (stripWasPushed) {
+			imageHasChanged = true;
+			fadeHelper.addStrips(1);
+		}
 	}
 
 	if (imageHasChanged) {
@@ -232,13 +255,18 @@ void Spectrogram::vProcess(ProcessContext context, ExternalData& externalData) {
 			}
 		}
 
-		auto& snapshot = externalData.cast<Snapshot>();
+		imageVersion++;
+		imageHasChanged = false;
+	}
+
+	// snapshot may hold older image even if nothing has changed since last call
+	auto& snapshot = externalData.cast<Snapshot>();
+	if (snapshot.pixelsVersion != imageVersion) {
 		snapshot.writeNeeded = true;
 		snapshot.empty = image.isEmpty();
 
 		snapshot.pixels.copyWithResize(params.fading != 0.0 ? fadeHelper.getResultBuffer() : image.getPixels());
-
-		imageHasChanged = false;
+		snapshot.pixelsVersion = imageVersion;
 	}
 }
 
@@ -249,13 +277,73 @@ void Spectrogram::staticFinisher(const Snapshot& snapshot, const ExternCallConte
 
 	snapshot.filenameBuffer = snapshot.prefix;
 	snapshot.filenameBuffer += context.legacyNumber < 104 ? context.channelName : context.filePrefix;
-	snapshot.filenameBuffer += L".bmp";
+	snapshot.filenameBuffer += utils::ImageFormatUtils::getExtension(snapshot.imageFormat);
 
-	snapshot.writerHelper.write(snapshot.pixels, snapshot.empty, snapshot.filenameBuffer);
+	snapshot.writerHelper.write(
+		snapshot.pixels, snapshot.empty,
+		snapshot.filenameBuffer, snapshot.imageFormat, context.imageWriteQueue
+	);
 	snapshot.writeNeeded = false;
 }
 
+void Spectrogram::InputStripMaker::makeColorTable(
+	array_view<ColorDescription> colors, array_view<float> colorLevels
+) {
+	tableLowValue = colorLevels.front();
+	tableScale = float(colorTableSize - 1) / (colorLevels.back() - colorLevels.front());
+
+	std::vector<float> values;
+	values.resize(colorTableSize);
+	for (index i = 0; i < colorTableSize; i++) {
+		values[i] = tableLowValue + float(i) / tableScale;
+	}
+	// rounding errors must not push last value out of range
+	values.back() = colorLevels.back();
+
+	colorTable.resize(colorTableSize);
+	if (colors.size() == 2) {
+		interpolateTwoColors(colors, colorLevels, values, colorTable);
+	} else {
+		interpolateMulticolor(colors, colorLevels, values, colorTable);
+	}
+}
+
 void Spectrogram::InputStripMaker::fillStrip(array_view<float> data, array_span<utils::IntColor> buffer) const {
+	const index size = buffer.size();
+	const utils::IntColor* table = colorTable.data();
+
+	const __m128 lowValue = _mm_set1_ps(tableLowValue);
+	const __m128 scale = _mm_set1_ps(tableScale);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 maxIndex = _mm_set1_ps(float(colorTableSize - 1));
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	index i = 0;
+	alignas(16) int32_t indices[4];
+	for (; i + 4 <= size; i += 4) {
+		__m128 position = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(data.data() + i), lowValue), scale);
+		// max returns second operand for NaN, so invalid values get the lowest color
+		position = _mm_min_ps(_mm_max_ps(position, zero), maxIndex);
+		// position is not negative, so truncation after adding 0.5 rounds half up, same as in the scalar loop
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(_mm_add_ps(position, half)));
+
+		buffer[i + 0] = table[indices[0]];
+		buffer[i + 1] = table[indices[1]];
+		buffer[i + 2] = table[indices[2]];
+		buffer[i + 3] = table[indices[3]];
+	}
+
+	for (; i < size; i++) {
+		float position = (data[i] - tableLowValue) * tableScale;
+		position = std::min(std::max(0.0f, position), float(colorTableSize - 1));
+		buffer[i] = table[index(position + 0.5f)];
+	}
+}
+
+void Spectrogram::InputStripMaker::interpolateTwoColors(
+	array_view<ColorDescription> colors, array_view<float> colorLevels,
+	array_view<float> data, array_span<utils::IntColor> buffer
+) {
 	const utils::LinearInterpolatorF interpolator{ colorLevels.front(), colorLevels.back(), 0.0, 1.0 };
 	const auto lowColor = colors[0].color;
 	const auto highColor = colors[1].color;
@@ -268,9 +356,10 @@ void Spectrogram::InputStripMaker::fillStrip(array_view<float> data, array_span<
 	}
 }
 
-void Spectrogram::InputStripMaker::fillStripMulticolor(
+void Spectrogram::InputStripMaker::interpolateMulticolor(
+	array_view<ColorDescription> colors, array_view<float> colorLevels,
 	array_view<float> data, array_span<utils::IntColor> buffer
-) const {
+) {
 	for (index i = 0; i < buffer.size(); ++i) {
 		const auto value = std::clamp(data[i], colorLevels.front(), colorLevels.back());
 
@@ -303,7 +392,7 @@ bool Spectrogram::getProp(
 	if (prop == L"file") {
 		snapshot.filenameBuffer = snapshot.prefix;
 		snapshot.filenameBuffer += context.legacyNumber < 104 ? context.channelName : context.filePrefix;
-		snapshot.filenameBuffer += L".bmp";
+		snapshot.filenameBuffer += utils::ImageFormatUtils::getExtension(snapshot.imageFormat);
 
 		printer.print(snapshot.filenameBuffer);
 		return true;
@@ -313,5 +402,8 @@ bool Spectrogram::getProp(
 		return true;
 	}
 
-	return false;
+	snapshot.filenameBuffer = snapshot.prefix;
+	snapshot.filenameBuffer += context.legacyNumber < 104 ? context.channelName : context.filePrefix;
+	snapshot.filenameBuffer += utils::ImageFormatUtils::getExtension(snapshot.imageFormat);
+	return utils::ImageWriteHelper::getQueueProp(prop, snapshot.filenameBuffer, context.imageWriteQueue, printer);
 }
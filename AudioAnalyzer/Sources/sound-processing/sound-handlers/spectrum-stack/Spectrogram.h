@@ -37,6 +37,7 @@ namespace rxtd::audio_analyzer {
 			index length{ };
 			index borderSize{ };
 			string folder = { };
+			utils::ImageFormat imageFormat{ };
 			utils::Color borderColor{ };
 			double fading{ };
 
@@ -53,6 +54,7 @@ namespace rxtd::audio_analyzer {
 					&& lhs.length == rhs.length
 					&& lhs.borderSize == rhs.borderSize
 					&& lhs.folder == rhs.folder
+					&& lhs.imageFormat == rhs.imageFormat
 					&& lhs.borderColor == rhs.borderColor
 					&& lhs.fading == rhs.fading
 					&& lhs.colorLevels == rhs.colorLevels
@@ -71,9 +73,12 @@ namespace rxtd::audio_analyzer {
 			index blockSize{ };
 
 			string prefix;
+			utils::ImageFormat imageFormat{ };
 
 			utils::Vector2D<utils::IntColor> pixels;
 			bool empty{ };
+			// snapshots are reused in turn, so each of them may hold different version of the image
+			index pixelsVersion{ };
 
 			mutable utils::ImageWriteHelper writerHelper{ };
 			mutable bool writeNeeded{ };
@@ -82,11 +87,19 @@ namespace rxtd::audio_analyzer {
 		};
 
 		class InputStripMaker {
+			// Gradient is sampled into a table once per configuration,
+			// so that each pixel only needs an index computation and a lookup.
+			// Step of the table is less than 1/4000 of the range of color values,
+			// which is below what 8-bit color channels can show for the most gradients.
+			static constexpr index colorTableSize = 4096;
+
 			index counter{ };
 			index blockSize{ };
 			index chunkEquivalentWaveSize{ };
-			array_view<ColorDescription> colors;
-			array_view<float> colorLevels;
+
+			std::vector<utils::IntColor> colorTable;
+			float tableLowValue{ };
+			float tableScale{ };
 
 			array_view<array_view<float>> chunks;
 			std::vector<utils::IntColor> buffer{ };
@@ -98,12 +111,12 @@ namespace rxtd::audio_analyzer {
 			) {
 				blockSize = _blockSize;
 				chunkEquivalentWaveSize = _chunkEquivalentWaveSize;
-				colors = _colors;
-				colorLevels = _colorLevels;
 				counter = 0;
 
+				makeColorTable(_colors, _colorLevels);
+
 				buffer.resize(bufferSize);
-				std::fill(buffer.begin(), buffer.end(), colors[0].color.toIntColor());
+				std::fill(buffer.begin(), buffer.end(), colorTable.front());
 			}
 
 			[[nodiscard]]
@@ -128,19 +141,22 @@ namespace rxtd::audio_analyzer {
 				}
 
 				if (!chunk.empty()) {
-					if (colors.size() == 2) {
-						// only use 2 colors
-						fillStrip(chunk, buffer);
-					} else {
-						// many colors, but slightly slower
-						fillStripMulticolor(chunk, buffer);
-					}
+					fillStrip(chunk, buffer);
 				}
 			}
 
 		private:
+			void makeColorTable(array_view<ColorDescription> colors, array_view<float> colorLevels);
 			void fillStrip(array_view<float> data, array_span<utils::IntColor> buffer) const;
-			void fillStripMulticolor(array_view<float> data, array_span<utils::IntColor> buffer) const;
+
+			static void interpolateTwoColors(
+				array_view<ColorDescription> colors, array_view<float> colorLevels,
+				array_view<float> data, array_span<utils::IntColor> buffer
+			);
+			static void interpolateMulticolor(
+				array_view<ColorDescription> colors, array_view<float> colorLevels,
+				array_view<float> data, array_span<utils::IntColor> buffer
+			);
 		};
 
 		Params params;
@@ -149,6 +165,7 @@ namespace rxtd::audio_analyzer {
 
 
 		mutable bool imageHasChanged = false;
+		index imageVersion{ };
 
 		audio_utils::MinMaxCounter minMaxCounter;
 
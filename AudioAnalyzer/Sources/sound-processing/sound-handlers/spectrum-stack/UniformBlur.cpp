@@ -29,6 +29,16 @@ SoundHandler::ParseResult UniformBlur::parseParams(
 	params.blurRadius = std::max<double>(om.get(L"Radius").asFloat(1.0) * 0.25, 0.0);
 	params.blurRadiusAdaptation = std::max<double>(om.get(L"RadiusAdaptation").asFloat(2.0), 0.0);
 
+	if (const auto methodString = om.get(L"Method").asIString(L"Exact");
+		methodString == L"Exact") {
+		params.method = Method::eEXACT;
+	} else if (methodString == L"Recursive") {
+		params.method = Method::eRECURSIVE;
+	} else {
+		cl.warning(L"Method '{}' is not recognized, assume 'Exact'", methodString);
+		params.method = Method::eEXACT;
+	}
+
 	result.sources.emplace_back(sourceId);
 	return result;
 }
@@ -78,6 +88,15 @@ void UniformBlur::vProcess(ProcessContext context, ExternalData& externalData) {
 }
 
 void UniformBlur::blurCascade(array_view<float> source, array_span<float> dest, index radius) {
+	if (params.method == Method::eRECURSIVE && radius >= minRecursiveRadius) {
+		recursiveGaussian.apply(source, dest, radius);
+		return;
+	}
+
+	blurCascadeExact(source, dest, radius);
+}
+
+void UniformBlur::blurCascadeExact(array_view<float> source, array_span<float> dest, index radius) {
 	auto kernel = gcm.forRadius(radius);
 
 	const auto bandsCount = source.size();
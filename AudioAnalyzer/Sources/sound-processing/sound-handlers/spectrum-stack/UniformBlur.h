@@ -11,16 +11,24 @@
 #include "../SoundHandler.h"
 #include "ResamplerProvider.h"
 #include "../../../audio-utils/GaussianCoefficientsManager.h"
+#include "../../../audio-utils/RecursiveGaussian.h"
 
 namespace rxtd::audio_analyzer {
 	class UniformBlur : public ResamplerProvider {
+		enum class Method {
+			eEXACT,
+			eRECURSIVE,
+		};
+
 		struct Params {
 			double blurRadius{ };
 			double blurRadiusAdaptation{ };
+			Method method{ };
 
 			friend bool operator==(const Params& lhs, const Params& rhs) {
 				return lhs.blurRadius == rhs.blurRadius
-					&& lhs.blurRadiusAdaptation == rhs.blurRadiusAdaptation;
+					&& lhs.blurRadiusAdaptation == rhs.blurRadiusAdaptation
+					&& lhs.method == rhs.method;
 			}
 
 			friend bool operator!=(const Params& lhs, const Params& rhs) {
@@ -28,8 +36,13 @@ namespace rxtd::audio_analyzer {
 			}
 		};
 
+		// recursive approximation is meant for sigma above 1,
+		// and exact kernel is cheap for small radii anyway
+		static constexpr index minRecursiveRadius = 4;
+
 		Params params{ };
 		audio_utils::GaussianCoefficientsManager gcm;
+		audio_utils::RecursiveGaussian recursiveGaussian;
 		double startingRadius{ };
 
 	public:
@@ -53,5 +66,6 @@ namespace rxtd::audio_analyzer {
 
 	private:
 		void blurCascade(array_view<float> source, array_span<float> dest, index radius);
+		void blurCascadeExact(array_view<float> source, array_span<float> dest, index radius);
 	};
 }
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "windows-wrappers/FileWrapper.h"
+#include <cstdio>
+#include <filesystem>
+
+using namespace utils;
+
+FileWrapper::FileWrapper(const wchar_t* path) {
+	fileHandle = std::fopen(std::filesystem::path{ path }.c_str(), "wb");
+}
+
+FileWrapper::~FileWrapper() {
+	close();
+}
+
+bool FileWrapper::isValid() const {
+	return fileHandle != nullptr;
+}
+
+void FileWrapper::write(const void* data, index count) {
+	if (!isValid()) {
+		return;
+	}
+
+	const auto bytesWritten = std::fwrite(data, 1, size_t(count), static_cast<std::FILE*>(fileHandle));
+	if (index(bytesWritten) != count) {
+		close();
+	}
+}
+
+string FileWrapper::getAbsolutePath(string folder, sview currentPath) {
+	std::filesystem::path path{ folder };
+	if (!path.is_absolute()) {
+		path = std::filesystem::path{ currentPath } / path;
+	}
+
+	folder = std::filesystem::absolute(path).wstring();
+	if (folder.empty() || folder.back() != L'/') {
+		folder += L'/';
+	}
+
+	return folder;
+}
+
+void FileWrapper::createDirectories(string path) {
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path{ path }.parent_path(), error);
+}
+
+bool FileWrapper::replaceFile(const string& source, const string& dest) {
+	std::error_code error;
+	std::filesystem::rename(source, dest, error);
+	return !error;
+}
+
+void FileWrapper::close() {
+	if (fileHandle != nullptr) {
+		std::fclose(static_cast<std::FILE*>(fileHandle));
+		fileHandle = nullptr;
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "windows-wrappers/MirroredMemory.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace utils;
+
+MirroredMemory::MirroredMemory(index minSize) {
+	const index pageSize = sysconf(_SC_PAGESIZE);
+	const index mappingSize = std::max<index>((minSize + pageSize - 1) / pageSize, 1) * pageSize;
+
+	const int fd = memfd_create("MirroredMemory", 0);
+	if (fd < 0) {
+		return;
+	}
+
+	if (ftruncate(fd, off_t(mappingSize)) != 0) {
+		close(fd);
+		return;
+	}
+
+	// unlike Windows, address range can be reserved first and then filled with views
+	void* address = mmap(nullptr, size_t(mappingSize * 2), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (address == MAP_FAILED) {
+		close(fd);
+		return;
+	}
+
+	const auto first = static_cast<std::byte*>(address);
+	const bool success =
+		mmap(first, size_t(mappingSize), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED
+		&& mmap(first + mappingSize, size_t(mappingSize), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+
+	// views keep the memory alive
+	close(fd);
+
+	if (!success) {
+		munmap(address, size_t(mappingSize * 2));
+		return;
+	}
+
+	pointer = first;
+	size = mappingSize;
+}
+
+void MirroredMemory::release() {
+	if (pointer != nullptr) {
+		munmap(pointer, size_t(size * 2));
+		pointer = nullptr;
+	}
+	size = 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+// Replaces Common/sources/RainmeterWrappers.cpp on other systems.
+// There is no dll that could be unloaded while messages are in flight,
+// so messages are sent right away instead of from a separate thread.
+
+#include "RainmeterWrappers.h"
+#include <mutex>
+
+#include "RainmeterAPI.h"
+
+using namespace utils;
+
+namespace {
+	// handlers can log from worker threads
+	std::mutex sendMutex;
+}
+
+Rainmeter::InstanceKeeper::InstanceKeeper(void*) {
+	initialized = true;
+}
+
+void Rainmeter::InstanceKeeper::deinit() {
+	initialized = false;
+}
+
+void Rainmeter::Logger::logRainmeter(LogLevel logLevel, sview message) const {
+	const string text = message % own();
+	std::lock_guard<std::mutex> lock{ sendMutex };
+	RmLog(rm, static_cast<int>(logLevel), text.c_str());
+}
+
+Rainmeter::Rainmeter(void* rm) :
+	rm(rm) {
+	skin = Skin{ RmGetSkin(rm) };
+	measureName = RmGetMeasureName(rm);
+}
+
+sview Rainmeter::readString(sview optionName, const wchar_t* defaultValue, bool replaceVariables) const {
+	return RmReadString(rm, makeNullTerminated(optionName), defaultValue, replaceVariables);
+}
+
+sview Rainmeter::readPath(sview optionName, const wchar_t* defaultValue) const {
+	return RmReadPath(rm, makeNullTerminated(optionName), defaultValue);
+}
+
+double Rainmeter::readDouble(sview optionName, double defaultValue) const {
+	return RmReadFormula(rm, makeNullTerminated(optionName), defaultValue);
+}
+
+sview Rainmeter::replaceVariables(sview string) const {
+	return RmReplaceVariables(rm, makeNullTerminated(string));
+}
+
+sview Rainmeter::transformPathToAbsolute(sview path) const {
+	return RmPathToAbsolute(rm, makeNullTerminated(path));
+}
+
+void Rainmeter::executeCommandAsync(sview command, Skin skin) {
+	const string text = command % own();
+	std::lock_guard<std::mutex> lock{ sendMutex };
+	RmExecute(skin.getRawPointer(), text.c_str());
+}
+
+void* Rainmeter::getWindowHandle() {
+	return RmGetSkinWindow(rm);
+}
+
+void Rainmeter::sourcelessLog(const wchar_t* message) {
+	std::lock_guard<std::mutex> lock{ sendMutex };
+	RmLog(nullptr, static_cast<int>(Logger::LogLevel::eDEBUG), message);
+}
+
+Rainmeter::InstanceKeeper Rainmeter::getInstanceKeeper() {
+	return InstanceKeeper{ rm };
+}
+
+const wchar_t* Rainmeter::makeNullTerminated(sview view) const {
+	// can't use view[view.length()] because it's out of view's range
+	if (view.data()[view.length()] == L'\0') {
+		return view.data();
+	}
+
+	optionNameBuffer = view;
+	return optionNameBuffer.c_str();
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+// Replaces Windows.h on other systems.
+// Contains only what RainmeterAPI.h and processing code need.
+
+#pragma once
+#include <cstdint>
+
+using BOOL = int;
+using DWORD = uint32_t;
+using LPCWSTR = const wchar_t*;
+using HWND = void*;
+
+#define TRUE 1
+#define FALSE 0
+
+#define EXTERN_C extern "C"
+#define __declspec(x)
+#define __stdcall
+#define __cdecl
+#define __inline inline
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+#include "RainmeterApiStub.h"
+#include "ParamParser.h"
+#include "WaveFileReader.h"
+#include "sound-processing/ChannelMixer.h"
+#include "sound-processing/ProcessingOrchestrator.h"
+
+using namespace audio_analyzer;
+
+namespace {
+	void printUsage() {
+		std::wcerr << L"Usage: AudioAnalyzerBenchmark <skin file> <measure section> <wav file> [update rate] [realtime]\n";
+		std::wcerr << L"Parent measure options are read from the specified section of the skin file.\n";
+		std::wcerr << L"Update rate defaults to 60. If \"realtime\" is specified, file is played in real time,\n";
+		std::wcerr << L"otherwise it is processed as fast as possible.\n";
+	}
+
+	double toMs(SoundHandler::clock::duration value) {
+		return std::chrono::duration<double, std::milli>{ value }.count();
+	}
+}
+
+int main(int argc, char* argv[]) {
+	using clock = SoundHandler::clock;
+
+	if (argc < 4) {
+		printUsage();
+		return 1;
+	}
+
+	// path converts arguments from native narrow encoding
+	std::vector<string> args;
+	for (index i = 0; i < argc; i++) {
+		args.push_back(std::filesystem::path{ argv[i] }.wstring());
+	}
+
+	benchmark::StubMeasure measure;
+	measure.iniPath = std::filesystem::absolute(args[1]).wstring();
+	measure.section = args[2];
+	const string wavePath = args[3];
+	const double updateRate = argc > 4 ? std::clamp(std::wcstod(args[4].c_str(), nullptr), 1.0, 1000.0) : 60.0;
+	const bool realtime = argc > 5 && utils::Option{ args[5] }.asIString() == L"realtime";
+
+	if (!benchmark::readOptions(measure)) {
+		std::wcerr << L"Can't read skin file '" << measure.iniPath << L"'\n";
+		return 1;
+	}
+
+	utils::Rainmeter rain{ &measure };
+	auto instanceKeeper = rain.getInstanceKeeper();
+	auto logger = rain.createLogger();
+	utils::BufferPrinter bp;
+
+	utils::WaveFileReader reader{ wavePath };
+	if (!reader.isValid()) {
+		logger.error(L"Can't read wave file '{}': {}", wavePath, reader.getErrorMessage());
+		return 1;
+	}
+
+	const auto format = reader.getFormat();
+	const auto layout = ChannelUtils::parseLayout(format.channelMask);
+	if (layout.ordered().empty()) {
+		logger.error(L"zero known channels are found in the channel layout of the file");
+		return 1;
+	}
+
+	ChannelMixer channelMixer;
+	channelMixer.setLayout(layout);
+
+	const index legacyNumber = rain.read(L"MagicNumber").asInt(0);
+
+	ParamParser paramParser;
+	paramParser.setRainmeter(rain);
+	paramParser.parse(legacyNumber, false);
+
+	const auto threadingMap = rain.read(L"threading").asMap(L'|', L' ');
+
+	ProcessingOrchestrator orchestrator;
+	orchestrator.setLogger(logger);
+	orchestrator.setWarnTime(-1.0);
+	orchestrator.setKillTimeout(std::clamp(threadingMap.get(L"killTimeout").asFloat(33.0), 0.01, 33.0));
+	orchestrator.setWorkersCount(std::clamp<index>(threadingMap.get(L"workers").asInt(0), 0, 16));
+	orchestrator.patch(paramParser.getParseResult(), legacyNumber, format.samplesPerSec, layout);
+
+	ProcessingOrchestrator::Snapshot snapshot;
+	orchestrator.configureSnapshot(snapshot);
+
+	const index chunkSize = std::max<index>(std::llround(double(format.samplesPerSec) / updateRate), 1);
+
+	std::vector<clock::duration> updateTimes;
+	updateTimes.reserve(reader.getFramesCount() / chunkSize + 1);
+	index framesProcessed = 0;
+
+	const auto benchmarkBeginTime = clock::now();
+	while (true) {
+		const index framesRead = reader.read(chunkSize);
+		if (framesRead == 0) {
+			break;
+		}
+
+		channelMixer.reset();
+		channelMixer.saveChannelsData(reader.getBuffer());
+		channelMixer.createAuto();
+
+		const auto updateBeginTime = clock::now();
+		orchestrator.process(channelMixer, snapshot);
+		updateTimes.push_back(clock::now() - updateBeginTime);
+
+		framesProcessed += framesRead;
+
+		if (realtime) {
+			const auto playTime = std::chrono::duration<double>{ double(framesProcessed) / double(format.samplesPerSec) };
+			std::this_thread::sleep_until(benchmarkBeginTime + std::chrono::duration_cast<clock::duration>(playTime));
+		}
+	}
+
+	if (updateTimes.empty()) {
+		logger.error(L"file doesn't have any data");
+		return 1;
+	}
+
+	clock::duration totalTime{ };
+	for (auto time : updateTimes) {
+		totalTime += time;
+	}
+	auto sortedTimes = updateTimes;
+	std::sort(sortedTimes.begin(), sortedTimes.end());
+	const auto p99Time = sortedTimes[index(double(sortedTimes.size() - 1) * 0.99)];
+
+	const double audioSec = double(framesProcessed) / double(format.samplesPerSec);
+	const double totalSec = std::chrono::duration<double>{ totalTime }.count();
+
+	bp.print(
+		L"file: {} Hz, {} channels, {} s",
+		format.samplesPerSec, format.channelsCount, audioSec
+	);
+	std::wcout << bp.getBufferPtr() << L'\n';
+	bp.print(
+		L"updates: {}, {} frames per update",
+		updateTimes.size(), chunkSize
+	);
+	std::wcout << bp.getBufferPtr() << L'\n';
+	bp.print(
+		L"update time, ms: mean {}, p99 {}, max {}",
+		toMs(totalTime) / double(updateTimes.size()), toMs(p99Time), toMs(sortedTimes.back())
+	);
+	std::wcout << bp.getBufferPtr() << L'\n';
+	bp.print(
+		L"total processing time: {} s, {} x realtime",
+		totalSec, totalSec > 0.0 ? audioSec / totalSec : 0.0
+	);
+	std::wcout << bp.getBufferPtr() << L'\n';
+
+	std::wcout << L"\nprocessing\tchannel\thandler\tcalls\tmean, ms\tmax, ms\tx realtime\n";
+	orchestrator.visitHandlerTimings([&](isview procName, Channel channel, isview handlerName, const auto& timing) {
+		const double handlerSec = std::chrono::duration<double>{ timing.total }.count();
+		bp.print(
+			L"{}\t{}\t{}\t{}\t{}\t{}\t{}",
+			procName % csView(), ChannelUtils::getTechnicalName(channel), handlerName % csView(),
+			timing.callsCount,
+			timing.callsCount > 0 ? toMs(timing.total) / double(timing.callsCount) : 0.0,
+			toMs(timing.max),
+			handlerSec > 0.0 ? audioSec / handlerSec : 0.0
+		);
+		std::wcout << bp.getBufferPtr() << L'\n';
+	});
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+// This file implements functions that are usually imported from Rainmeter.dll,
+// so that plugin code can be run without Rainmeter.
+#define LIBRARY_EXPORTS
+#include "RainmeterAPI.h"
+
+#include "RainmeterApiStub.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace benchmark;
+
+namespace {
+	StubMeasure& getMeasure(void* rm) {
+		return *static_cast<StubMeasure*>(rm);
+	}
+
+	// std::filesystem::path knows how to convert both encodings into native wide strings
+	string decodeFile(const std::string& bytes) {
+		if (bytes.size() >= 2 && uint8_t(bytes[0]) == 0xFF && uint8_t(bytes[1]) == 0xFE) {
+			std::u16string text;
+			text.reserve(bytes.size() / 2);
+			for (index i = 2; i + 1 < index(bytes.size()); i += 2) {
+				text.push_back(char16_t(uint8_t(bytes[i]) | uint8_t(bytes[i + 1]) << 8));
+			}
+			return std::filesystem::path{ text }.wstring();
+		}
+
+		if (bytes.size() >= 3 && bytes.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+			return std::filesystem::u8path(bytes.begin() + 3, bytes.end()).wstring();
+		}
+		return std::filesystem::u8path(bytes).wstring();
+	}
+
+	sview trim(sview view) {
+		const auto begin = view.find_first_not_of(L" \t\r");
+		if (begin == sview::npos) {
+			return { };
+		}
+		const auto end = view.find_last_not_of(L" \t\r");
+		return view.substr(begin, end - begin + 1);
+	}
+}
+
+bool benchmark::readOptions(StubMeasure& measure) {
+	std::ifstream file{ std::filesystem::path{ measure.iniPath }, std::ios::binary };
+	if (!file) {
+		return false;
+	}
+	const std::string bytes{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{ } };
+
+	const string text = decodeFile(bytes);
+	const isview section = measure.section % ciView();
+
+	measure.options.clear();
+	bool insideSection = false;
+	for (index lineBegin = 0; lineBegin < index(text.size());) {
+		index lineEnd = index(text.find(L'\n', lineBegin));
+		if (lineEnd < 0) {
+			lineEnd = index(text.size());
+		}
+		const sview line = trim(sview{ text }.substr(lineBegin, lineEnd - lineBegin));
+		lineBegin = lineEnd + 1;
+
+		if (line.empty() || line.front() == L';') {
+			continue;
+		}
+
+		if (line.front() == L'[') {
+			const auto closing = line.find(L']');
+			insideSection = closing != sview::npos && trim(line.substr(1, closing - 1)) % ciView() == section;
+			continue;
+		}
+
+		if (!insideSection) {
+			continue;
+		}
+
+		const auto separator = line.find(L'=');
+		if (separator == sview::npos) {
+			continue;
+		}
+
+		const sview name = trim(line.substr(0, separator));
+		sview value = trim(line.substr(separator + 1));
+		// Rainmeter removes quotes that enclose whole value
+		if (value.length() >= 2 && value.front() == L'"' && value.back() == L'"') {
+			value = value.substr(1, value.length() - 2);
+		}
+
+		// first option with the same name wins
+		measure.options.emplace(name % ciView() % own(), value);
+	}
+
+	return true;
+}
+
+LPCWSTR __stdcall RmReadString(void* rm, LPCWSTR option, LPCWSTR defValue, BOOL) {
+	auto& measure = getMeasure(rm);
+
+	const auto iter = measure.options.find(sview{ option } % ciView());
+	measure.readBuffer = iter == measure.options.end() ? defValue : iter->second;
+	return measure.readBuffer.c_str();
+}
+
+double __stdcall RmReadFormula(void* rm, LPCWSTR option, double defValue) {
+	const auto value = RmReadString(rm, option, L"", false);
+	wchar_t* end = nullptr;
+	const double result = std::wcstod(value, &end);
+	return end == value ? defValue : result;
+}
+
+LPCWSTR __stdcall RmReplaceVariables(void*, LPCWSTR str) {
+	return str;
+}
+
+LPCWSTR __stdcall RmPathToAbsolute(void* rm, LPCWSTR relativePath) {
+	auto& measure = getMeasure(rm);
+
+	std::filesystem::path path{ relativePath };
+	if (path.is_relative()) {
+		path = std::filesystem::path{ measure.iniPath }.parent_path() / path;
+	}
+
+	measure.pathBuffer = path.wstring();
+	return measure.pathBuffer.c_str();
+}
+
+void __stdcall RmExecute(void*, LPCWSTR) {
+	// there is no skin to execute bangs in
+}
+
+void* __stdcall RmGet(void* rm, int type) {
+	switch (type) {
+	case RMG_MEASURENAME:
+		return const_cast<wchar_t*>(getMeasure(rm).section.c_str());
+	case RMG_SKIN:
+		return rm;
+	case RMG_SETTINGSFILE:
+	case RMG_SKINNAME:
+		return const_cast<wchar_t*>(L"");
+	default:
+		return nullptr;
+	}
+}
+
+void __stdcall RmLog(void*, int level, LPCWSTR message) {
+	const wchar_t* levelName;
+	switch (level) {
+	case 1:
+		levelName = L"Error";
+		break;
+	case 2:
+		levelName = L"Warning";
+		break;
+	case 3:
+		levelName = L"Notice";
+		break;
+	default:
+		levelName = L"Debug";
+		break;
+	}
+
+	std::fwprintf(stderr, L"%ls: %ls\n", levelName, message);
+}
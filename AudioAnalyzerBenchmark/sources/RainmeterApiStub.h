@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+
+namespace rxtd::benchmark {
+	// Replacement of a Rainmeter measure for functions from RainmeterAPI.h.
+	// Options are read from one section of an ini file.
+	// Variables and section variables are not replaced.
+	struct StubMeasure {
+		string iniPath;
+		string section;
+
+		// option names are case insensitive, like in Rainmeter
+		std::map<istring, string, std::less<>> options;
+
+		// pointers returned from API functions are valid until next call, like in Rainmeter
+		string readBuffer;
+		string pathBuffer;
+	};
+
+	// Reads options of measure.section from measure.iniPath.
+	// File can be in UTF-16 with BOM, like files that Rainmeter writes, or in UTF-8.
+	// Returns false if file can't be read.
+	[[nodiscard]]
+	bool readOptions(StubMeasure& measure);
+}
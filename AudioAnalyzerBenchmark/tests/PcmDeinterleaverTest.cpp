@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+// Compares PcmDeinterleaver with a plain scalar conversion.
+// Results must be bit-exact, and nothing outside of requested ranges may be touched.
+// Source buffers are allocated with exact size, so that AddressSanitizer can catch reads past the end,
+// and destination buffers are surrounded by guard values that must stay unchanged.
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "PcmDeinterleaver.h"
+
+// glibc declares ::index() in <cstring>, so everything lives in the namespace where rxtd::index wins
+namespace rxtd::utils {
+	namespace {
+		using SampleFormat = PcmDeinterleaver::SampleFormat;
+
+		constexpr index guardSize = 4;
+		constexpr float guardValue = -12345.0f;
+
+		// same formulas as in the format description, written without any vectorization
+		float convertReference(const uint8_t* bytes, SampleFormat format) {
+			switch (format) {
+			case SampleFormat::eInt16: {
+				int16_t value;
+				std::memcpy(&value, bytes, sizeof(value));
+				return float(value) * (1.0f / std::numeric_limits<int16_t>::max());
+			}
+			case SampleFormat::eInt24: {
+				int32_t value = int32_t(bytes[0]) | int32_t(bytes[1]) << 8 | int32_t(bytes[2]) << 16;
+				if (value >= 1 << 23) {
+					value -= 1 << 24;
+				}
+				return float(value) * (1.0f / ((1 << 23) - 1));
+			}
+			case SampleFormat::eInt32: {
+				int32_t value;
+				std::memcpy(&value, bytes, sizeof(value));
+				return float(value) * (1.0f / std::numeric_limits<int32_t>::max());
+			}
+			case SampleFormat::eFloat: {
+				float value;
+				std::memcpy(&value, bytes, sizeof(value));
+				return value;
+			}
+			}
+			return 0.0f;
+		}
+
+		const wchar_t* getFormatName(SampleFormat format) {
+			switch (format) {
+			case SampleFormat::eInt16: return L"int16";
+			case SampleFormat::eInt24: return L"int24";
+			case SampleFormat::eInt32: return L"int32";
+			case SampleFormat::eFloat: return L"float";
+			}
+			return L"unknown";
+		}
+
+		std::vector<uint8_t> generateSource(SampleFormat format, index samplesCount, index offset, std::mt19937& random) {
+			const index sampleSize = PcmDeinterleaver::getSampleSize(format);
+			std::vector<uint8_t> result(offset + samplesCount * sampleSize);
+
+			if (format != SampleFormat::eFloat) {
+				std::uniform_int_distribution<int> byteDistribution{ 0, 255 };
+				for (auto& byte : result) {
+					byte = uint8_t(byteDistribution(random));
+				}
+				return result;
+			}
+
+			// random bytes would give a lot of NaNs, which can't show conversion errors
+			std::uniform_real_distribution<float> valueDistribution{ -2.0f, 2.0f };
+			for (index i = 0; i < samplesCount; i++) {
+				const float value = valueDistribution(random);
+				std::memcpy(result.data() + offset + i * sampleSize, &value, sizeof(value));
+			}
+			return result;
+		}
+
+		// returns true if test has passed
+		bool testCase(SampleFormat format, index channelsCount, index framesCount, index sourceOffset, index destOffset, std::mt19937& random) {
+			const index sampleSize = PcmDeinterleaver::getSampleSize(format);
+			const auto source = generateSource(format, framesCount * channelsCount, sourceOffset, random);
+			const uint8_t* sourceData = source.data() + sourceOffset;
+
+			std::vector<std::vector<float>> buffers;
+			std::vector<array_span<float>> dest;
+			buffers.reserve(channelsCount);
+			for (index channel = 0; channel < channelsCount; channel++) {
+				buffers.emplace_back(guardSize + destOffset + framesCount + guardSize, guardValue);
+				dest.emplace_back(buffers.back().data() + guardSize + destOffset, framesCount);
+			}
+
+			PcmDeinterleaver::deinterleave(sourceData, format, framesCount, dest);
+
+			for (index channel = 0; channel < channelsCount; channel++) {
+				const auto& buffer = buffers[channel];
+				for (index i = 0; i < index(buffer.size()); i++) {
+					const index frame = i - guardSize - destOffset;
+					const bool insideRange = frame >= 0 && frame < framesCount;
+					const float expected = insideRange
+						? convertReference(sourceData + (frame * channelsCount + channel) * sampleSize, format)
+						: guardValue;
+
+					if (std::memcmp(&buffer[i], &expected, sizeof(float)) != 0) {
+						std::wcerr << L"FAIL: " << getFormatName(format)
+							<< L", channels " << channelsCount
+							<< L", frames " << framesCount
+							<< L", source offset " << sourceOffset
+							<< L", dest offset " << destOffset
+							<< L": channel " << channel
+							<< (insideRange ? L", frame " : L", guard position ") << (insideRange ? frame : i)
+							<< L", expected " << expected << L", got " << buffer[i] << L'\n';
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		// returns process exit code
+		int runAllCases() {
+			std::mt19937 random{ 20200701 };
+
+			const SampleFormat formats[] = {
+				SampleFormat::eInt16,
+				SampleFormat::eInt24,
+				SampleFormat::eInt32,
+				SampleFormat::eFloat,
+			};
+
+			// everything around the 4-frame vector step, and a few larger buffers
+			std::vector<index> framesCounts;
+			for (index i = 0; i <= 17; i++) {
+				framesCounts.push_back(i);
+			}
+			framesCounts.push_back(255);
+			framesCounts.push_back(1023);
+			framesCounts.push_back(1025);
+
+			index casesCount = 0;
+			index failsCount = 0;
+			for (auto format : formats) {
+				for (index channelsCount = 1; channelsCount <= 9; channelsCount++) {
+					for (auto framesCount : framesCounts) {
+						// offsets break alignment of source and destination
+						for (index sourceOffset = 0; sourceOffset < 2; sourceOffset++) {
+							for (index destOffset = 0; destOffset < 2; destOffset++) {
+								casesCount++;
+								if (!testCase(format, channelsCount, framesCount, sourceOffset, destOffset, random)) {
+									failsCount++;
+								}
+							}
+						}
+					}
+				}
+			}
+
+			std::wcout << casesCount - failsCount << L" of " << casesCount << L" cases passed\n";
+			return failsCount == 0 ? 0 : 1;
+		}
+	}
+}
+
+int main() {
+	return rxtd::utils::runAllCases();
+}
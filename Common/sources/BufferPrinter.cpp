@@ -37,6 +37,12 @@ sview BufferPrinter::ReadableOutputBuffer::getBuffer() {
 }
 
 void BufferPrinter::ReadableOutputBuffer::resetPointers() {
+	if (buffer.empty()) {
+		// buffer.size() - 1 would point before the null pointer
+		setp(nullptr, nullptr);
+		return;
+	}
+
 	char_type* buf = buffer.data();
 	// buffer.size() - 1 because we need size for '\0' symbol at the end
 	setp(buf, buf + buffer.size() - 1);
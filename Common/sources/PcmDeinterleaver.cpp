@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "PcmDeinterleaver.h"
+#include <cstring>
+#include <emmintrin.h>
+
+namespace rxtd::utils {
+	namespace {
+		// Each loader converts samples, addressed by their number in the interleaved stream:
+		// #load1 reads one sample, #load2 reads 2 consecutive samples into lower half of a vector,
+		// #load4 reads 4 consecutive samples.
+		// Loaders never read memory past the last requested sample.
+
+		struct FloatLoader {
+			static constexpr index sampleSize = sizeof(float);
+
+			static float load1(const uint8_t* source, index sample) {
+				float result;
+				std::memcpy(&result, source + sample * sampleSize, sizeof(result));
+				return result;
+			}
+
+			static __m128 load2(const uint8_t* source, index sample) {
+				return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(source + sample * sampleSize)));
+			}
+
+			static __m128 load4(const uint8_t* source, index sample) {
+				return _mm_loadu_ps(reinterpret_cast<const float*>(source + sample * sampleSize));
+			}
+		};
+
+		struct Int16Loader {
+			static constexpr index sampleSize = sizeof(int16_t);
+			static constexpr float scale = 1.0f / std::numeric_limits<int16_t>::max();
+
+			static float load1(const uint8_t* source, index sample) {
+				int16_t result;
+				std::memcpy(&result, source + sample * sampleSize, sizeof(result));
+				return float(result) * scale;
+			}
+
+			static __m128 load2(const uint8_t* source, index sample) {
+				int32_t pair;
+				std::memcpy(&pair, source + sample * sampleSize, sizeof(pair));
+				return convert(_mm_cvtsi32_si128(pair));
+			}
+
+			static __m128 load4(const uint8_t* source, index sample) {
+				return convert(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + sample * sampleSize)));
+			}
+
+		private:
+			// converts 4 lower int16 values
+			static __m128 convert(__m128i values) {
+				// put each value into the high half of 32-bit lane and then shift it back with sign extension
+				const __m128i extended = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+				return _mm_mul_ps(_mm_cvtepi32_ps(extended), _mm_set1_ps(scale));
+			}
+		};
+
+		struct Int24Loader {
+			static constexpr index sampleSize = 3;
+			static constexpr float scale = 1.0f / ((1 << 23) - 1);
+
+			static float load1(const uint8_t* source, index sample) {
+				return float(readShifted(source, sample) >> 8) * scale;
+			}
+
+			static __m128 load2(const uint8_t* source, index sample) {
+				return convert(_mm_setr_epi32(readShifted(source, sample), readShifted(source, sample + 1), 0, 0));
+			}
+
+			static __m128 load4(const uint8_t* source, index sample) {
+				// SSE2 has no byte shuffle, so packed samples are assembled one by one
+				return convert(
+					_mm_setr_epi32(
+						readShifted(source, sample),
+						readShifted(source, sample + 1),
+						readShifted(source, sample + 2),
+						readShifted(source, sample + 3)
+					)
+				);
+			}
+
+		private:
+			// returns sample in the 3 high bytes of the result
+			static int32_t readShifted(const uint8_t* source, index sample) {
+				const uint8_t* bytes = source + sample * sampleSize;
+				return int32_t(uint32_t(bytes[0]) << 8 | uint32_t(bytes[1]) << 16 | uint32_t(bytes[2]) << 24);
+			}
+
+			static __m128 convert(__m128i shifted) {
+				return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(shifted, 8)), _mm_set1_ps(scale));
+			}
+		};
+
+		struct Int32Loader {
+			static constexpr index sampleSize = sizeof(int32_t);
+			static constexpr float scale = 1.0f / std::numeric_limits<int32_t>::max();
+
+			static float load1(const uint8_t* source, index sample) {
+				int32_t result;
+				std::memcpy(&result, source + sample * sampleSize, sizeof(result));
+				return float(result) * scale;
+			}
+
+			static __m128 load2(const uint8_t* source, index sample) {
+				return convert(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + sample * sampleSize)));
+			}
+
+			static __m128 load4(const uint8_t* source, index sample) {
+				return convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + sample * sampleSize)));
+			}
+
+		private:
+			static __m128 convert(__m128i values) {
+				return _mm_mul_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(scale));
+			}
+		};
+
+		// spans in #dest are not modified themselves, only the data they point to
+		float* getChannelData(array_view<array_span<float>> dest, index channel) {
+			array_span<float> span = dest[channel];
+			return span.data();
+		}
+
+		template<typename Loader>
+		void deinterleaveScalar(
+			const uint8_t* source, index framesBegin, index framesEnd, array_view<array_span<float>> dest
+		) {
+			const index channelsCount = dest.size();
+			for (index frame = framesBegin; frame < framesEnd; frame++) {
+				for (index channel = 0; channel < channelsCount; channel++) {
+					getChannelData(dest, channel)[frame] = Loader::load1(source, frame * channelsCount + channel);
+				}
+			}
+		}
+
+		template<typename Loader>
+		void deinterleave1(const uint8_t* source, index framesCount, array_view<array_span<float>> dest) {
+			float* const out = getChannelData(dest, 0);
+
+			index frame = 0;
+			for (; frame + 4 <= framesCount; frame += 4) {
+				_mm_storeu_ps(out + frame, Loader::load4(source, frame));
+			}
+
+			deinterleaveScalar<Loader>(source, frame, framesCount, dest);
+		}
+
+		template<typename Loader>
+		void deinterleave2(const uint8_t* source, index framesCount, array_view<array_span<float>> dest) {
+			float* const out0 = getChannelData(dest, 0);
+			float* const out1 = getChannelData(dest, 1);
+
+			index frame = 0;
+			for (; frame + 4 <= framesCount; frame += 4) {
+				const __m128 frames01 = Loader::load4(source, frame * 2);
+				const __m128 frames23 = Loader::load4(source, frame * 2 + 4);
+				_mm_storeu_ps(out0 + frame, _mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(out1 + frame, _mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+
+			deinterleaveScalar<Loader>(source, frame, framesCount, dest);
+		}
+
+		template<typename Loader>
+		void deinterleave6(const uint8_t* source, index framesCount, array_view<array_span<float>> dest) {
+			float* out[6];
+			for (index channel = 0; channel < 6; channel++) {
+				out[channel] = getChannelData(dest, channel);
+			}
+
+			index frame = 0;
+			for (; frame + 4 <= framesCount; frame += 4) {
+				// channels 0-3 of each frame form a 4x4 matrix
+				__m128 row0 = Loader::load4(source, frame * 6 + 0);
+				__m128 row1 = Loader::load4(source, frame * 6 + 6);
+				__m128 row2 = Loader::load4(source, frame * 6 + 12);
+				__m128 row3 = Loader::load4(source, frame * 6 + 18);
+				_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+				_mm_storeu_ps(out[0] + frame, row0);
+				_mm_storeu_ps(out[1] + frame, row1);
+				_mm_storeu_ps(out[2] + frame, row2);
+				_mm_storeu_ps(out[3] + frame, row3);
+
+				// channels 4-5 are pairs that only need to be split into odd and even
+				const __m128 pairs01 = _mm_movelh_ps(Loader::load2(source, frame * 6 + 4), Loader::load2(source, frame * 6 + 10));
+				const __m128 pairs23 = _mm_movelh_ps(Loader::load2(source, frame * 6 + 16), Loader::load2(source, frame * 6 + 22));
+				_mm_storeu_ps(out[4] + frame, _mm_shuffle_ps(pairs01, pairs23, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(out[5] + frame, _mm_shuffle_ps(pairs01, pairs23, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+
+			deinterleaveScalar<Loader>(source, frame, framesCount, dest);
+		}
+
+		template<typename Loader>
+		void deinterleave8(const uint8_t* source, index framesCount, array_view<array_span<float>> dest) {
+			float* out[8];
+			for (index channel = 0; channel < 8; channel++) {
+				out[channel] = getChannelData(dest, channel);
+			}
+
+			index frame = 0;
+			for (; frame + 4 <= framesCount; frame += 4) {
+				for (index half = 0; half < 2; half++) {
+					const index offset = frame * 8 + half * 4;
+					__m128 row0 = Loader::load4(source, offset + 0);
+					__m128 row1 = Loader::load4(source, offset + 8);
+					__m128 row2 = Loader::load4(source, offset + 16);
+					__m128 row3 = Loader::load4(source, offset + 24);
+					_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+					_mm_storeu_ps(out[half * 4 + 0] + frame, row0);
+					_mm_storeu_ps(out[half * 4 + 1] + frame, row1);
+					_mm_storeu_ps(out[half * 4 + 2] + frame, row2);
+					_mm_storeu_ps(out[half * 4 + 3] + frame, row3);
+				}
+			}
+
+			deinterleaveScalar<Loader>(source, frame, framesCount, dest);
+		}
+
+		template<typename Loader>
+		void deinterleaveWith(const uint8_t* source, index framesCount, array_view<array_span<float>> dest) {
+			switch (dest.size()) {
+			case 1:
+				deinterleave1<Loader>(source, framesCount, dest);
+				break;
+			case 2:
+				deinterleave2<Loader>(source, framesCount, dest);
+				break;
+			case 6:
+				deinterleave6<Loader>(source, framesCount, dest);
+				break;
+			case 8:
+				deinterleave8<Loader>(source, framesCount, dest);
+				break;
+			default:
+				deinterleaveScalar<Loader>(source, 0, framesCount, dest);
+				break;
+			}
+		}
+	}
+
+	index PcmDeinterleaver::getSampleSize(SampleFormat format) {
+		switch (format) {
+		case SampleFormat::eInt16: return Int16Loader::sampleSize;
+		case SampleFormat::eInt24: return Int24Loader::sampleSize;
+		case SampleFormat::eInt32: return Int32Loader::sampleSize;
+		case SampleFormat::eFloat: return FloatLoader::sampleSize;
+		}
+		return 0;
+	}
+
+	void PcmDeinterleaver::deinterleave(
+		const void* source, SampleFormat format, index framesCount, array_view<array_span<float>> dest
+	) {
+		if (framesCount <= 0 || dest.empty()) {
+			return;
+		}
+
+		const auto bytes = static_cast<const uint8_t*>(source);
+
+		switch (format) {
+		case SampleFormat::eInt16:
+			deinterleaveWith<Int16Loader>(bytes, framesCount, dest);
+			break;
+		case SampleFormat::eInt24:
+			deinterleaveWith<Int24Loader>(bytes, framesCount, dest);
+			break;
+		case SampleFormat::eInt32:
+			deinterleaveWith<Int32Loader>(bytes, framesCount, dest);
+			break;
+		case SampleFormat::eFloat:
+			deinterleaveWith<FloatLoader>(bytes, framesCount, dest);
+			break;
+		}
+	}
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+
+namespace rxtd::utils {
+	// Converts interleaved PCM data into one float array per channel.
+	// Source is read only once, regardless of channels count.
+	// Integer samples are normalized by max value of their type.
+	// Doesn't use any OS API, so it can be used without audio devices.
+	class PcmDeinterleaver {
+	public:
+		enum class SampleFormat {
+			eInt16,
+			eInt24, // packed, 3 bytes per sample
+			eInt32,
+			eFloat,
+		};
+
+		[[nodiscard]]
+		static index getSampleSize(SampleFormat format);
+
+		// #dest must contain one span per channel, each at least #framesCount long
+		static void deinterleave(const void* source, SampleFormat format, index framesCount, array_view<array_span<float>> dest);
+	};
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <type_traits>
+
+#include "windows-wrappers/MirroredMemory.h"
+
+namespace rxtd::utils {
+	// FIFO buffer with the same interface as GrowingVector
+	// that never moves stored data when old elements are removed.
+	//
+	// Big buffers use memory that is mapped twice into adjacent address ranges,
+	// so any stored sequence is contiguous even when it wraps around the end of the buffer.
+	// Small buffers, and buffers that OS doesn't allow to map, use a plain array instead
+	// that is compacted only when write position reaches the end of the array.
+	// Each mapping takes a kernel handle and at least 64 KB of address space twice,
+	// which is a waste for buffers of a few KB, and compaction of them is cheap anyway.
+	//
+	// Spans returned by any function are invalidated by next #allocateNext call.
+	template <typename T>
+	class RingBuffer : MovableOnlyBase {
+		static_assert(std::is_trivially_copyable<T>::value);
+
+		// allocation granularity of Windows
+		static constexpr index minMirroredSizeBytes = 64 * 1024;
+
+		MirroredMemory mirroredMemory;
+		std::vector<T> fallbackArray;
+
+		T* data = nullptr;
+		index capacity = 0;
+		index readPosition = 0;
+		index size = 0;
+		index minCapacity = 0;
+
+	public:
+		// Set the size that buffer can hold without reallocation
+		// Buffer grows automatically, so this value is only a hint
+		void setMaxSize(index value) {
+			minCapacity = value;
+			if (capacity < minCapacity) {
+				grow(minCapacity);
+			}
+		}
+
+		[[nodiscard]]
+		index getRemainingSize() const {
+			return size;
+		}
+
+		[[nodiscard]]
+		bool empty() const {
+			return size == 0;
+		}
+
+		// Contents of returned span are unspecified
+		[[nodiscard]]
+		array_span<T> allocateNext(index chunkSize) {
+			if (size + chunkSize > capacity) {
+				grow(size + chunkSize);
+			}
+
+			if (!mirroredMemory.isValid() && readPosition + size + chunkSize > index(fallbackArray.size())) {
+				std::copy_n(data + readPosition, size, data);
+				readPosition = 0;
+			}
+
+			const index writePosition = readPosition + size;
+			size += chunkSize;
+
+			return { data + writePosition, chunkSize };
+		}
+
+		[[nodiscard]]
+		array_span<T> getFirst(index chunkSize) {
+			if (chunkSize > size) {
+				return { };
+			}
+			return { data + readPosition, chunkSize };
+		}
+
+		[[nodiscard]]
+		array_view<T> getFirst(index chunkSize) const {
+			if (chunkSize > size) {
+				return { };
+			}
+			return { data + readPosition, chunkSize };
+		}
+
+		array_span<T> removeFirst(index chunkSize) {
+			if (chunkSize > size) {
+				return { };
+			}
+			array_span<T> result{ data + readPosition, chunkSize };
+
+			readPosition += chunkSize;
+			size -= chunkSize;
+			if (mirroredMemory.isValid() && readPosition >= capacity) {
+				readPosition -= capacity;
+			}
+
+			return result;
+		}
+
+		// returns all elements that are not removed yet
+		[[nodiscard]]
+		array_span<T> getAllData() {
+			return { data + readPosition, size };
+		}
+
+		[[nodiscard]]
+		array_view<T> getAllData() const {
+			return { data + readPosition, size };
+		}
+
+		void reset() {
+			readPosition = 0;
+			size = 0;
+		}
+
+	private:
+		void grow(index requiredCapacity) {
+			requiredCapacity = std::max(requiredCapacity, capacity * 2);
+
+			const index requiredSizeBytes = requiredCapacity * index(sizeof(T));
+			MirroredMemory newMemory;
+			if (requiredSizeBytes >= minMirroredSizeBytes) {
+				newMemory = MirroredMemory{ requiredSizeBytes };
+			}
+			if (newMemory.getSize() % index(sizeof(T)) != 0) {
+				// wrap point must not split an element
+				newMemory = { };
+			}
+
+			std::vector<T> newArray;
+			T* newData;
+			index newCapacity;
+			if (newMemory.isValid()) {
+				newData = reinterpret_cast<T*>(newMemory.getPointer());
+				newCapacity = newMemory.getSize() / index(sizeof(T));
+			} else {
+				// allocate twice the capacity so that compaction happens rarely
+				newArray.resize(requiredCapacity * 2);
+				newData = newArray.data();
+				newCapacity = requiredCapacity;
+			}
+
+			if (size > 0) {
+				std::copy_n(data + readPosition, size, newData);
+			}
+
+			mirroredMemory = std::move(newMemory);
+			fallbackArray = std::move(newArray);
+			data = newData;
+			capacity = newCapacity;
+			readPosition = 0;
+		}
+	};
+}
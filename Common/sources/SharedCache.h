@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace rxtd::utils {
+	// Storage of immutable values that are expensive to create.
+	// All users that request the same key get the same object.
+	// Cache doesn't own values: value is destroyed when its last user releases it.
+	// Can be used from several threads at once.
+	template<typename Key, typename Value>
+	class SharedCache {
+		std::mutex mutex;
+		std::map<Key, std::weak_ptr<const Value>> entries;
+
+	public:
+		// #factory is called without arguments and must return Value,
+		// it's only called when there is no value for #key
+		template<typename Factory>
+		[[nodiscard]]
+		std::shared_ptr<const Value> get(const Key& key, Factory factory) {
+			std::lock_guard<std::mutex> lock{ mutex };
+
+			removeExpired();
+
+			auto& entry = entries[key];
+			auto result = entry.lock();
+			if (result == nullptr) {
+				result = std::make_shared<const Value>(factory());
+				entry = result;
+			}
+
+			return result;
+		}
+
+	private:
+		void removeExpired() {
+			for (auto iter = entries.begin(); iter != entries.end();) {
+				if (iter->second.expired()) {
+					iter = entries.erase(iter);
+				} else {
+					++iter;
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+
+namespace rxtd::utils {
+	// Wait-free exchange of data between one producer thread and one consumer thread.
+	//
+	// Producer fills the back buffer and then publishes it,
+	// consumer takes the last published buffer when it wants.
+	// Buffers are never copied, publishing and taking are single atomic exchanges,
+	// so neither side ever waits for the other one.
+	//
+	// Consumer can skip some published buffers when producer is faster.
+	// Producer gets buffers back in an unspecified state,
+	// so it must either overwrite all data in the back buffer
+	// or be able to tell whether stored data is up to date.
+	template<typename T>
+	class TripleBuffer : NonMovableBase {
+		static constexpr uint8_t indexMask = 0b011;
+		static constexpr uint8_t freshBit = 0b100;
+
+		std::array<T, 3> buffers{ };
+
+		index backIndex = 0;
+		// index of the buffer that is between producer and consumer, plus fresh bit
+		std::atomic<uint8_t> middleState{ 1 };
+		index frontIndex = 2;
+
+	public:
+		// producer side
+
+		[[nodiscard]]
+		T& getBack() {
+			return buffers[backIndex];
+		}
+
+		void publish() {
+			const uint8_t oldState = middleState.exchange(uint8_t(backIndex) | freshBit, std::memory_order_acq_rel);
+			backIndex = oldState & indexMask;
+		}
+
+		// consumer side
+
+		// Returns true if front buffer has changed.
+		// References to the old front buffer must not be used after this call.
+		bool acquire() {
+			if ((middleState.load(std::memory_order_relaxed) & freshBit) == 0) {
+				return false;
+			}
+
+			const uint8_t oldState = middleState.exchange(uint8_t(frontIndex), std::memory_order_acq_rel);
+			frontIndex = oldState & indexMask;
+			return true;
+		}
+
+		[[nodiscard]]
+		T& getFront() {
+			return buffers[frontIndex];
+		}
+
+		[[nodiscard]]
+		const T& getFront() const {
+			return buffers[frontIndex];
+		}
+	};
+}
@@ -20,7 +20,7 @@ namespace rxtd::utils {
 
 	class TypeHolder : NonMovableBase, VirtualDestructorBase {
 	protected:
-		using Rainmeter = Rainmeter;
+		using Rainmeter = utils::Rainmeter;
 		using Logger = Rainmeter::Logger;
 		
 		Rainmeter rain;
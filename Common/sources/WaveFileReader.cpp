@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "WaveFileReader.h"
+#include <cstring>
+#include <filesystem>
+
+namespace rxtd::utils {
+	namespace {
+		constexpr uint16_t formatTagPcm = 0x0001;
+		constexpr uint16_t formatTagFloat = 0x0003;
+		constexpr uint16_t formatTagExtensible = 0xFFFE;
+
+		// values of SPEAKER_* constants from ksmedia.h
+		constexpr uint32_t speakerFrontCenter = 0x4;
+		constexpr index maxSpeakerBits = 18;
+
+		// RIFF is always little endian, and so are all platforms we run on
+		template<typename T>
+		T readValue(const char* data) {
+			T result;
+			std::memcpy(&result, data, sizeof(T));
+			return result;
+		}
+
+		index countBits(uint32_t value) {
+			index result = 0;
+			while (value != 0) {
+				value &= value - 1;
+				result++;
+			}
+			return result;
+		}
+	}
+
+	WaveFileReader::WaveFileReader(const string& path) {
+		file.open(std::filesystem::path{ path }, std::ios::binary);
+		if (!file.is_open()) {
+			errorMessage = L"file can't be opened";
+			return;
+		}
+
+		readHeader();
+	}
+
+	index WaveFileReader::read(index count) {
+		if (!isValid()) {
+			return 0;
+		}
+
+		count = std::min(count, framesCount - position);
+		if (count <= 0) {
+			buffer.setBufferSize(0);
+			return 0;
+		}
+
+		rawBuffer.resize(count * frameSize);
+		file.read(rawBuffer.data(), std::streamsize(rawBuffer.size()));
+		const index framesRead = index(file.gcount()) / frameSize;
+		if (framesRead < count) {
+			// file is shorter than its header says
+			file.clear();
+			framesCount = position + framesRead;
+		}
+		position += framesRead;
+
+		const index channelsCount = format.channelsCount;
+		buffer.setBuffersCount(channelsCount);
+		buffer.setBufferSize(framesRead);
+
+		bufferChannels.clear();
+		for (index channel = 0; channel < channelsCount; channel++) {
+			bufferChannels.push_back(buffer[channel]);
+		}
+		PcmDeinterleaver::deinterleave(rawBuffer.data(), sampleType, framesRead, bufferChannels);
+
+		return framesRead;
+	}
+
+	void WaveFileReader::rewind() {
+		if (!isValid()) {
+			return;
+		}
+
+		file.clear();
+		file.seekg(dataBegin);
+		position = 0;
+	}
+
+	void WaveFileReader::readHeader() {
+		char riffHeader[12];
+		if (!file.read(riffHeader, sizeof(riffHeader))
+			|| std::memcmp(riffHeader, "RIFF", 4) != 0
+			|| std::memcmp(riffHeader + 8, "WAVE", 4) != 0) {
+			errorMessage = L"file is not a RIFF WAVE file";
+			return;
+		}
+
+		bool formatFound = false;
+		while (true) {
+			char chunkHeader[8];
+			if (!file.read(chunkHeader, sizeof(chunkHeader))) {
+				errorMessage = L"data chunk is not found";
+				return;
+			}
+
+			const auto chunkSize = index(readValue<uint32_t>(chunkHeader + 4));
+
+			if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+				if (!readFormatChunk(chunkSize)) {
+					return;
+				}
+				formatFound = true;
+				continue;
+			}
+
+			if (std::memcmp(chunkHeader, "data", 4) == 0) {
+				if (!formatFound) {
+					errorMessage = L"data chunk is found before format chunk";
+					return;
+				}
+
+				dataBegin = file.tellg();
+
+				index dataSize = chunkSize;
+				if (dataSize == 0 || dataSize == index(std::numeric_limits<uint32_t>::max())) {
+					// files that are still being written often have placeholder size
+					file.seekg(0, std::ios::end);
+					dataSize = index(file.tellg() - dataBegin);
+					file.seekg(dataBegin);
+				}
+
+				framesCount = dataSize / frameSize;
+				return;
+			}
+
+			// chunks are aligned to 2 bytes
+			file.seekg(chunkSize + chunkSize % 2, std::ios::cur);
+		}
+	}
+
+	bool WaveFileReader::readFormatChunk(index chunkSize) {
+		if (chunkSize < 16) {
+			errorMessage = L"format chunk is too small";
+			return false;
+		}
+
+		std::vector<char> chunk;
+		chunk.resize(chunkSize + chunkSize % 2);
+		if (!file.read(chunk.data(), std::streamsize(chunk.size()))) {
+			errorMessage = L"format chunk is truncated";
+			return false;
+		}
+
+		uint16_t formatTag = readValue<uint16_t>(chunk.data() + 0);
+		const index channelsCount = readValue<uint16_t>(chunk.data() + 2);
+		const index samplesPerSec = readValue<uint32_t>(chunk.data() + 4);
+		const index blockAlign = readValue<uint16_t>(chunk.data() + 12);
+		const index bitsPerSample = readValue<uint16_t>(chunk.data() + 14);
+
+		uint32_t channelMask = 0;
+		if (formatTag == formatTagExtensible) {
+			if (chunkSize < 40) {
+				errorMessage = L"extensible format chunk is too small";
+				return false;
+			}
+			channelMask = readValue<uint32_t>(chunk.data() + 20);
+			// first 2 bytes of SubFormat GUID are the same as plain format tag
+			formatTag = readValue<uint16_t>(chunk.data() + 24);
+		}
+
+		if (formatTag == formatTagPcm && bitsPerSample == 16) {
+			sampleType = SampleType::eInt16;
+		} else if (formatTag == formatTagPcm && bitsPerSample == 24) {
+			sampleType = SampleType::eInt24;
+		} else if (formatTag == formatTagPcm && bitsPerSample == 32) {
+			sampleType = SampleType::eInt32;
+		} else if (formatTag == formatTagFloat && bitsPerSample == 32) {
+			sampleType = SampleType::eFloat;
+		} else {
+			errorMessage = L"only 16, 24, 32-bit integer and 32-bit float formats are supported";
+			return false;
+		}
+
+		if (channelsCount == 0 || samplesPerSec == 0) {
+			errorMessage = L"format chunk is invalid";
+			return false;
+		}
+		if (channelsCount > maxSpeakerBits) {
+			errorMessage = L"too many channels";
+			return false;
+		}
+
+		frameSize = channelsCount * bitsPerSample / 8;
+		if (blockAlign != frameSize) {
+			errorMessage = L"format chunk is invalid";
+			return false;
+		}
+
+		if (countBits(channelMask) != channelsCount) {
+			// Files without explicit layout use default speakers order
+			if (channelsCount == 1) {
+				channelMask = speakerFrontCenter;
+			} else {
+				channelMask = (1u << channelsCount) - 1;
+			}
+		}
+
+		format.samplesPerSec = samplesPerSec;
+		format.channelsCount = channelsCount;
+		format.channelMask = channelMask;
+
+		return true;
+	}
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <fstream>
+
+#include "PcmDeinterleaver.h"
+#include "Vector2D.h"
+#include "windows-wrappers/WaveFormat.h"
+
+namespace rxtd::utils {
+	// Streaming reader of RIFF WAVE files.
+	// Supports 16, 24 and 32-bit integer and 32-bit float samples,
+	// both with plain and WAVE_FORMAT_EXTENSIBLE headers.
+	// Doesn't use any OS API, so it can be used without audio devices.
+	class WaveFileReader : MovableOnlyBase {
+	public:
+		using SampleType = PcmDeinterleaver::SampleFormat;
+
+	private:
+		std::ifstream file;
+		sview errorMessage;
+
+		WaveFormat format;
+		SampleType sampleType{ };
+		index frameSize{ };
+
+		std::streamoff dataBegin{ };
+		index framesCount{ };
+		index position{ };
+
+		std::vector<char> rawBuffer;
+		Vector2D<float> buffer;
+		std::vector<array_span<float>> bufferChannels;
+
+	public:
+		WaveFileReader() = default;
+		explicit WaveFileReader(const string& path);
+
+		[[nodiscard]]
+		bool isValid() const {
+			return errorMessage.empty() && file.is_open();
+		}
+
+		[[nodiscard]]
+		sview getErrorMessage() const {
+			return errorMessage;
+		}
+
+		// channel mask is filled even when file doesn't have WAVE_FORMAT_EXTENSIBLE header
+		[[nodiscard]]
+		const WaveFormat& getFormat() const {
+			return format;
+		}
+
+		[[nodiscard]]
+		index getFramesCount() const {
+			return framesCount;
+		}
+
+		[[nodiscard]]
+		index getPosition() const {
+			return position;
+		}
+
+		// Reads at most #count next frames and stores them in internal buffer.
+		// Returns count of frames read, 0 means end of file.
+		index read(index count);
+
+		void rewind();
+
+		// one array per channel
+		[[nodiscard]]
+		array2d_view<float> getBuffer() const {
+			return buffer;
+		}
+
+	private:
+		void readHeader();
+		bool readFormatChunk(index chunkSize);
+	};
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "WorkerPool.h"
+
+using namespace utils;
+
+void WorkerPool::setWorkersCount(index value) {
+	value = std::max<index>(value, 0);
+	if (value == getWorkersCount()) {
+		return;
+	}
+
+	stop();
+
+	threads.reserve(value);
+	for (index i = 0; i < value; ++i) {
+		threads.emplace_back([this]() { threadFunction(); });
+	}
+}
+
+void WorkerPool::runImpl(index count, JobFunction function, void* context) {
+	if (count <= 0) {
+		return;
+	}
+
+	if (threads.empty() || count == 1) {
+		for (index i = 0; i < count; ++i) {
+			function(context, i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		jobFunction = function;
+		jobContext = context;
+		jobsCount = count;
+		nextJob = 0;
+		unfinishedWorkers = getWorkersCount();
+		batchId++;
+	}
+	wakeVariable.notify_all();
+
+	runJobs();
+
+	std::unique_lock<std::mutex> lock{ mutex };
+	doneVariable.wait(lock, [&] { return unfinishedWorkers == 0; });
+}
+
+void WorkerPool::runJobs() {
+	while (true) {
+		const index jobIndex = nextJob.fetch_add(1);
+		if (jobIndex >= jobsCount) {
+			break;
+		}
+		jobFunction(jobContext, jobIndex);
+	}
+}
+
+void WorkerPool::stop() {
+	if (threads.empty()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		stopRequest = true;
+	}
+	wakeVariable.notify_all();
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	threads.clear();
+
+	stopRequest = false;
+	batchId = 0;
+}
+
+void WorkerPool::threadFunction() {
+	index lastBatchId = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			wakeVariable.wait(lock, [&] { return stopRequest || batchId != lastBatchId; });
+			if (stopRequest) {
+				return;
+			}
+			lastBatchId = batchId;
+		}
+
+		runJobs();
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			unfinishedWorkers--;
+			if (unfinishedWorkers == 0) {
+				doneVariable.notify_one();
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace rxtd::utils {
+	// Persistent set of threads that runs batches of independent jobs.
+	// Thread that calls #run also takes part in processing the batch,
+	// so pool without workers just runs everything in the calling thread.
+	class WorkerPool : NonMovableBase {
+		using JobFunction = void(*)(void* context, index jobIndex);
+
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable wakeVariable;
+		std::condition_variable doneVariable;
+
+		JobFunction jobFunction = nullptr;
+		void* jobContext = nullptr;
+		index jobsCount = 0;
+		std::atomic<index> nextJob{ 0 };
+
+		index unfinishedWorkers = 0;
+		index batchId = 0;
+		bool stopRequest = false;
+
+	public:
+		WorkerPool() = default;
+
+		~WorkerPool() {
+			stop();
+		}
+
+		// count of threads in addition to the calling thread
+		void setWorkersCount(index value);
+
+		[[nodiscard]]
+		index getWorkersCount() const {
+			return index(threads.size());
+		}
+
+		// calls callable(i) for each i in [0, count)
+		// returns when all calls are finished
+		template<typename Callable>
+		void run(index count, Callable& callable) {
+			runImpl(
+				count,
+				[](void* context, index jobIndex) { (*static_cast<Callable*>(context))(jobIndex); },
+				&callable
+			);
+		}
+
+	private:
+		void runImpl(index count, JobFunction function, void* context);
+		void runJobs();
+		void stop();
+		void threadFunction();
+	};
+}
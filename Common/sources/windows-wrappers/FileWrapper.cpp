@@ -91,6 +91,10 @@ void FileWrapper::createDirectories(string path) {
 	}
 }
 
+bool FileWrapper::replaceFile(const string& source, const string& dest) {
+	return MoveFileExW(source.c_str(), dest.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
 void FileWrapper::close() {
 	if (fileHandle != INVALID_HANDLE_VALUE) {
 		CloseHandle(fileHandle);
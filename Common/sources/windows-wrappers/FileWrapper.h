@@ -27,6 +27,10 @@ namespace rxtd::utils {
 
 		static void createDirectories(string path);
 
+		// moves source file into dest, replacing dest if it exists
+		// returns false on error
+		static bool replaceFile(const string& source, const string& dest);
+
 	private:
 		void close();
 	};
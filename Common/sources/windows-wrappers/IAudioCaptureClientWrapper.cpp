@@ -17,62 +17,28 @@ static_assert(std::is_same<UINT32, uint32_t>::value);
 
 // static_assert(std::is_same<DWORD, uint32_t>::value); // ...
 
-void IAudioCaptureClientWrapper::readBuffer() {
-	uint8_t* data = nullptr;
+index IAudioCaptureClientWrapper::lockBuffer(uint8_t*& data, bool& silent) {
 	DWORD flags{ };
-	uint32_t dataSize;
-	lastResult = ref().GetBuffer(&data, &dataSize, &flags, nullptr, nullptr);
+	uint32_t framesCount;
+	lastResult = ref().GetBuffer(&data, &framesCount, &flags, nullptr, nullptr);
 
-	if (lastResult != S_OK || dataSize == 0) {
-		return;
+	if (lastResult != S_OK || framesCount == 0) {
+		return 0;
 	}
 
-	const bool silent = (flags & AUDCLNT_BUFFERFLAGS_SILENT) != 0;
-
-	buffer.setBuffersCount(channelsCount);
-	buffer.setBufferSize(dataSize);
+	silent = (flags & AUDCLNT_BUFFERFLAGS_SILENT) != 0;
+	return index(framesCount);
+}
 
+void IAudioCaptureClientWrapper::copyData(
+	const uint8_t* data, bool silent, index framesCount, array_view<array_span<float>> dest
+) const {
 	if (silent) {
-		buffer.fill(0.0);
-	} else {
-		switch (type) {
-		case Type::eInt16:
-			for (index i = 0; i < channelsCount; i++) {
-				copyInt(data, buffer[i], i, channelsCount);
-			}
-			break;
-		case Type::eFloat:
-			for (index i = 0; i < channelsCount; i++) {
-				copyFloat(data, buffer[i], i, channelsCount);
-			}
-			break;
+		for (array_span<float> channelData : dest) {
+			std::fill_n(channelData.begin(), framesCount, 0.0f);
 		}
+		return;
 	}
 
-	ref().ReleaseBuffer(dataSize);
-}
-
-void IAudioCaptureClientWrapper::copyFloat(void* source, array_span<float> dest, index offset, index stride) {
-	const auto bufferInt = static_cast<const float*>(source);
-	const auto framesCount = dest.size();
-
-	auto channelSourceBuffer = bufferInt + offset;
-
-	for (index frame = 0; frame < framesCount; ++frame) {
-		dest[frame] = *channelSourceBuffer;
-		channelSourceBuffer += stride;
-	}
-}
-
-void IAudioCaptureClientWrapper::copyInt(void* source, array_span<float> dest, index offset, index stride) {
-	const auto bufferInt = static_cast<const int16_t*>(source);
-	const auto framesCount = dest.size();
-
-	auto channelSourceBuffer = bufferInt + offset;
-
-	for (index frame = 0; frame < framesCount; ++frame) {
-		const float value = float(*channelSourceBuffer) * (1.0f / std::numeric_limits<int16_t>::max());
-		dest[frame] = value;
-		channelSourceBuffer += stride;
-	}
+	PcmDeinterleaver::deinterleave(data, type, framesCount, dest);
 }
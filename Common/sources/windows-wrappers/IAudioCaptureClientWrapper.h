@@ -12,22 +12,17 @@
 #include "GenericComWrapper.h"
 #include <Audioclient.h>
 
-#include "Vector2D.h"
+#include "PcmDeinterleaver.h"
 
 namespace rxtd::utils {
 	class IAudioCaptureClientWrapper : public GenericComWrapper<IAudioCaptureClient> {
 	public:
-		enum class Type {
-			eInt16,
-			eFloat,
-		};
+		using Type = PcmDeinterleaver::SampleFormat;
 
 	private:
 		Type type{ };
 		index channelsCount{ };
 
-		Vector2D<float> buffer;
-
 		index lastResult{ };
 
 	public:
@@ -42,21 +37,38 @@ namespace rxtd::utils {
 			channelsCount = _channelsCount;
 		}
 
-		void readBuffer();
+		// Reads next packet straight into memory provided by #allocator.
+		// #allocator is called with frames count and must return one span per channel,
+		// each at least frames count long. It's not called if there is no data.
+		template<typename Allocator>
+		void readBuffer(Allocator allocator) {
+			uint8_t* data = nullptr;
+			bool silent = false;
+			const index framesCount = lockBuffer(data, silent);
+			if (framesCount == 0) {
+				return;
+			}
+
+			const array_view<array_span<float>> dest = allocator(framesCount);
+			copyData(data, silent, framesCount, dest);
+
+			ref().ReleaseBuffer(static_cast<UINT32>(framesCount));
+		}
 
 		[[nodiscard]]
-		index getLastResult() const {
-			return lastResult;
+		index getChannelsCount() const {
+			return channelsCount;
 		}
 
 		[[nodiscard]]
-		array2d_view<float> getBuffer() const {
-			return buffer;
+		index getLastResult() const {
+			return lastResult;
 		}
 
 	private:
-		static void copyFloat(void* source, array_span<float> dest, index offset, index stride);
+		// returns frames count, 0 if nothing was locked
+		index lockBuffer(uint8_t*& data, bool& silent);
 
-		static void copyInt(void* source, array_span<float> dest, index offset, index stride);
+		void copyData(const uint8_t* data, bool silent, index framesCount, array_view<array_span<float>> dest) const;
 	};
 }
@@ -14,6 +14,26 @@
 
 using namespace utils;
 
+namespace {
+	// returns false if integer samples of this size are not supported
+	bool findIntType(index bitsPerSample, IAudioCaptureClientWrapper::Type& type) {
+		using Type = IAudioCaptureClientWrapper::Type;
+		switch (bitsPerSample) {
+		case 16:
+			type = Type::eInt16;
+			return true;
+		case 24:
+			type = Type::eInt24;
+			return true;
+		case 32:
+			type = Type::eInt32;
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
 IAudioCaptureClientWrapper IAudioClientWrapper::openCapture() {
 	auto result = IAudioCaptureClientWrapper{
 		[&](auto ptr) {
@@ -157,8 +177,10 @@ void IAudioClientWrapper::readFormat() {
 	if (waveFormatRaw.wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
 		const auto& formatExtensible = reinterpret_cast<const WAVEFORMATEXTENSIBLE&>(waveFormatRaw);
 
-		if (formatExtensible.SubFormat == KSDATAFORMAT_SUBTYPE_PCM && formatExtensible.Format.wBitsPerSample == 16) {
-			formatType = IAudioCaptureClientWrapper::Type::eInt16;
+		if (formatExtensible.SubFormat == KSDATAFORMAT_SUBTYPE_PCM) {
+			// samples with fewer valid bits than container size are left-justified,
+			// so they only depend on container size
+			formatIsValid = findIntType(formatExtensible.Format.wBitsPerSample, formatType);
 		} else if (formatExtensible.SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT) {
 			formatType = IAudioCaptureClientWrapper::Type::eFloat;
 		} else {
@@ -167,8 +189,8 @@ void IAudioClientWrapper::readFormat() {
 
 		format.channelMask = formatExtensible.dwChannelMask;
 	} else {
-		if (waveFormatRaw.wFormatTag == WAVE_FORMAT_PCM && waveFormatRaw.wBitsPerSample == 16) {
-			formatType = IAudioCaptureClientWrapper::Type::eInt16;
+		if (waveFormatRaw.wFormatTag == WAVE_FORMAT_PCM) {
+			formatIsValid = findIntType(waveFormatRaw.wBitsPerSample, formatType);
 		} else if (waveFormatRaw.wFormatTag == WAVE_FORMAT_IEEE_FLOAT) {
 			formatType = IAudioCaptureClientWrapper::Type::eFloat;
 		} else {
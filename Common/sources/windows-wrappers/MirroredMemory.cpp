@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "MirroredMemory.h"
+#include "my-windows.h"
+
+using namespace utils;
+
+MirroredMemory::MirroredMemory(index minSize) {
+	SYSTEM_INFO systemInfo{ };
+	GetSystemInfo(&systemInfo);
+	const index granularity = systemInfo.dwAllocationGranularity;
+
+	const index mappingSize = std::max<index>((minSize + granularity - 1) / granularity, 1) * granularity;
+
+	mappingHandle = CreateFileMappingW(
+		INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		DWORD(uint64_t(mappingSize) >> 32), DWORD(uint64_t(mappingSize) & 0xFFFFFFFF),
+		nullptr
+	);
+	if (mappingHandle == nullptr) {
+		return;
+	}
+
+	// There is no way to reserve an address range and then map views into it
+	// without VirtualAlloc2 which requires Windows 10 1803,
+	// so find a free range, release it and hope that nobody takes it before we map views.
+	// If someone does, just try again.
+	constexpr index attemptsCount = 10;
+	for (index attempt = 0; attempt < attemptsCount; ++attempt) {
+		void* address = VirtualAlloc(nullptr, SIZE_T(mappingSize * 2), MEM_RESERVE, PAGE_NOACCESS);
+		if (address == nullptr) {
+			break;
+		}
+		VirtualFree(address, 0, MEM_RELEASE);
+
+		const auto first = static_cast<std::byte*>(
+			MapViewOfFileEx(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, SIZE_T(mappingSize), address)
+		);
+		if (first == nullptr) {
+			continue;
+		}
+
+		const auto second = MapViewOfFileEx(
+			mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, SIZE_T(mappingSize),
+			first + mappingSize
+		);
+		if (second == nullptr) {
+			UnmapViewOfFile(first);
+			continue;
+		}
+
+		pointer = first;
+		size = mappingSize;
+		return;
+	}
+
+	release();
+}
+
+void MirroredMemory::release() {
+	if (pointer != nullptr) {
+		UnmapViewOfFile(pointer + size);
+		UnmapViewOfFile(pointer);
+		pointer = nullptr;
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+	size = 0;
+}
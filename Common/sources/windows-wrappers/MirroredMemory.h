@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+
+namespace rxtd::utils {
+	// Block of memory that is mapped twice into adjacent address ranges:
+	// byte at (pointer + i) and byte at (pointer + size + i) is the same byte.
+	class MirroredMemory : MovableOnlyBase {
+		void* mappingHandle{ };
+		std::byte* pointer{ };
+		index size{ };
+
+	public:
+		MirroredMemory() = default;
+
+		// actual size is rounded up to allocation granularity
+		// object is invalid if OS didn't allow to create the mapping
+		explicit MirroredMemory(index minSize);
+
+		MirroredMemory(MirroredMemory&& other) noexcept {
+			mappingHandle = std::exchange(other.mappingHandle, nullptr);
+			pointer = std::exchange(other.pointer, nullptr);
+			size = std::exchange(other.size, 0);
+		}
+
+		MirroredMemory& operator=(MirroredMemory&& other) noexcept {
+			if (this == &other) {
+				return *this;
+			}
+
+			release();
+
+			mappingHandle = std::exchange(other.mappingHandle, nullptr);
+			pointer = std::exchange(other.pointer, nullptr);
+			size = std::exchange(other.size, 0);
+
+			return *this;
+		}
+
+		~MirroredMemory() {
+			release();
+		}
+
+		[[nodiscard]]
+		bool isValid() const {
+			return pointer != nullptr;
+		}
+
+		// size of one copy, whole address range is two times bigger
+		[[nodiscard]]
+		index getSize() const {
+			return size;
+		}
+
+		[[nodiscard]]
+		std::byte* getPointer() const {
+			return pointer;
+		}
+
+	private:
+		void release();
+	};
+}
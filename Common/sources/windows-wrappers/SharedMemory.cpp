@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "SharedMemory.h"
+#include "my-windows.h"
+
+using namespace utils;
+
+SharedMemory::SharedMemory(const string& name, index size) {
+	mappingHandle = CreateFileMappingW(
+		INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		DWORD(uint64_t(size) >> 32), DWORD(uint64_t(size) & 0xFFFFFFFF),
+		name.c_str()
+	);
+	if (mappingHandle == nullptr) {
+		return;
+	}
+
+	pointer = static_cast<std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, SIZE_T(size)));
+	if (pointer == nullptr) {
+		// happens when existing mapping is smaller than requested size
+		release();
+		return;
+	}
+
+	this->size = size;
+}
+
+void SharedMemory::release() {
+	if (pointer != nullptr) {
+		UnmapViewOfFile(pointer);
+		pointer = nullptr;
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+	size = 0;
+}
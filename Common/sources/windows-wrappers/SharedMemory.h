@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 rxtd
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#pragma once
+
+namespace rxtd::utils {
+	// Named block of memory that other processes can open by name.
+	class SharedMemory : MovableOnlyBase {
+		void* mappingHandle{ };
+		std::byte* pointer{ };
+		index size{ };
+
+	public:
+		SharedMemory() = default;
+
+		// If mapping with such name already exists, it is opened instead,
+		// and it can be smaller than #size, in which case object is invalid.
+		// Object is invalid if OS didn't allow to create the mapping.
+		SharedMemory(const string& name, index size);
+
+		SharedMemory(SharedMemory&& other) noexcept {
+			mappingHandle = std::exchange(other.mappingHandle, nullptr);
+			pointer = std::exchange(other.pointer, nullptr);
+			size = std::exchange(other.size, 0);
+		}
+
+		SharedMemory& operator=(SharedMemory&& other) noexcept {
+			if (this == &other) {
+				return *this;
+			}
+
+			release();
+
+			mappingHandle = std::exchange(other.mappingHandle, nullptr);
+			pointer = std::exchange(other.pointer, nullptr);
+			size = std::exchange(other.size, 0);
+
+			return *this;
+		}
+
+		~SharedMemory() {
+			release();
+		}
+
+		[[nodiscard]]
+		bool isValid() const {
+			return pointer != nullptr;
+		}
+
+		[[nodiscard]]
+		index getSize() const {
+			return size;
+		}
+
+		[[nodiscard]]
+		std::byte* getPointer() const {
+			return pointer;
+		}
+
+	private:
+		void release();
+	};
+}